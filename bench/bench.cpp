@@ -0,0 +1,340 @@
+/**
+ * bench/bench.cpp
+ * Micro-benchmarks de los caminos calientes del motor (make bench).
+ *
+ * Cada caso corre una pasada de calentamiento y luego 'repeat' pasadas con un
+ * número fijo de iteraciones; se informa la mediana y el mínimo en ns/op.
+ * Los casos que necesitan OpenGL usan una ventana oculta y se saltan si no hay
+ * contexto (máquinas headless). Los casos Lua están en bench/bench.lua.
+ *
+ * Uso: bin/xpp_bench [--json] [--out archivo] [--filter texto] [--repeat N] [--scale F] [--no-gl]
+ * Con --out el informe va al archivo (stdout puede llevar el eco de make).
+ */
+
+#include "../src/engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+
+// El binario de benchmarks no enlaza main.o: instancia propia del motor
+EngineState engine;
+
+struct BenchOptions {
+    bool json = false;
+    bool gl = true;
+    int repeat = 5;
+    std::string out;       // Archivo del informe (vacío = stdout)
+    double scale = 1.0;
+    std::string filter;
+};
+
+struct BenchResult {
+    std::string name;
+    Uint64 iterations = 0;
+    double median_ns = 0.0;
+    double min_ns = 0.0;
+    std::string skipped;   // Motivo si no se ejecutó
+};
+
+// Un caso mide sus propias iteraciones y devuelve nanosegundos medidos
+// (así puede dejar fuera la preparación, como llenar el batch antes de un flush)
+typedef std::function<double(Uint64 iterations)> BenchFn;
+
+static BenchOptions opts;
+static std::vector<BenchResult> results;
+static bool gl_ready = false;
+
+static double now_ns() {
+    using namespace std::chrono;
+    return (double)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static bool selected(const std::string& name) {
+    return opts.filter.empty() || name.find(opts.filter) != std::string::npos;
+}
+
+static void run_bench(const std::string& name, Uint64 iterations, bool needs_gl, const BenchFn& fn) {
+    if (!selected(name)) return;
+
+    BenchResult r;
+    r.name = name;
+    r.iterations = std::max<Uint64>(1, (Uint64)(iterations * opts.scale));
+
+    if (needs_gl && !gl_ready) {
+        r.skipped = "sin contexto OpenGL";
+        results.push_back(r);
+        return;
+    }
+
+    // Calentamiento: cachés, JIT de LuaJIT, buffers del driver
+    fn(std::max<Uint64>(1, r.iterations / 10));
+
+    std::vector<double> samples;
+    for (int i = 0; i < opts.repeat; ++i) {
+        samples.push_back(fn(r.iterations) / (double)r.iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    r.median_ns = samples[samples.size() / 2];
+    r.min_ns = samples.front();
+    results.push_back(r);
+}
+
+// ----------------------------------------------------------------------------
+// Casos nativos
+// ----------------------------------------------------------------------------
+
+static void bench_renderer() {
+    // Un sprite por op (incluye el flush amortizado cada MAX_SPRITES)
+    run_bench("draw_sprite", 1000000, true, [](Uint64 n) {
+        double t0 = now_ns();
+        for (Uint64 i = 0; i < n; ++i) {
+            draw_sprite(0, (float)(i & 255), 16.0f, 16.0f, 16.0f, 0, 0, 1, 1, 1, 1, 1, 1);
+        }
+        flush_batch();
+        return now_ns() - t0;
+    });
+
+    // Un flush de 1000 sprites por op hasta que la GPU termina (CPU + driver + GPU);
+    // el llenado del batch no se mide y la cola se vacía antes de empezar cada op
+    run_bench("flush_batch_1000", 2000, true, [](Uint64 n) {
+        double total = 0.0;
+        for (Uint64 i = 0; i < n; ++i) {
+            for (int s = 0; s < 1000; ++s) {
+                draw_sprite(0, (float)(s & 255), 16.0f, 16.0f, 16.0f, 0, 0, 1, 1, 1, 1, 1, 1);
+            }
+            glFinish();
+            double t0 = now_ns();
+            flush_batch();
+            glFinish();
+            total += now_ns() - t0;
+        }
+        return total;
+    });
+
+    // Solo el envío desde CPU (subida del VBO + draw call), sin esperar a la GPU
+    run_bench("flush_batch_1000_submit", 2000, true, [](Uint64 n) {
+        double total = 0.0;
+        for (Uint64 i = 0; i < n; ++i) {
+            for (int s = 0; s < 1000; ++s) {
+                draw_sprite(0, (float)(s & 255), 16.0f, 16.0f, 16.0f, 0, 0, 1, 1, 1, 1, 1, 1);
+            }
+            double t0 = now_ns();
+            flush_batch();
+            total += now_ns() - t0;
+        }
+        glFinish();
+        return total;
+    });
+}
+
+// Silencia std::cout durante los casos (luaopen_input imprime al registrarse)
+struct MuteCout {
+    std::ostringstream sink;
+    std::streambuf* old;
+    MuteCout() : old(std::cout.rdbuf(sink.rdbuf())) {}
+    ~MuteCout() { std::cout.rdbuf(old); }
+};
+
+int luaopen_util(lua_State* L);
+
+static void bench_lua_state() {
+    // luaL_requiref de un módulo sobre un estado ya abierto
+    run_bench("luaL_requiref_util", 200000, false, [](Uint64 n) {
+        lua_State* L = luaL_newstate();
+        luaL_openlibs(L);   // _LOADED existe a partir de aquí (fuera de la medida)
+        double t0 = now_ns();
+        for (Uint64 i = 0; i < n; ++i) {
+            luaL_requiref(L, "util", luaopen_util, 1);
+            lua_pop(L, 1);
+        }
+        double elapsed = now_ns() - t0;
+        lua_close(L);
+        return elapsed;
+    });
+
+    // Estado completo como en init_lua: newstate + openlibs + módulos + close
+    run_bench("lua_state_open_all", 2000, false, [](Uint64 n) {
+        MuteCout mute;
+        double t0 = now_ns();
+        for (Uint64 i = 0; i < n; ++i) {
+            lua_State* L = luaL_newstate();
+            luaL_openlibs(L);
+            open_engine_modules(L);
+            lua_close(L);
+        }
+        return now_ns() - t0;
+    });
+}
+
+// ----------------------------------------------------------------------------
+// Casos Lua (bench/bench.lua): { name, iterations, gl, setup(), run(n) }
+// ----------------------------------------------------------------------------
+
+static bool call_lua(lua_State* L, int nargs, const char* what) {
+    if (lua_pcall(L, nargs, 0, 0) != LUA_OK) {
+        std::cerr << "[BENCH] " << what << ": " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        return false;
+    }
+    return true;
+}
+
+static void bench_lua_cases(const char* path) {
+    lua_State* L = engine.L;
+    if (luaL_dofile(L, path) != LUA_OK || !lua_istable(L, -1)) {
+        std::cerr << "[BENCH] No se pudo cargar " << path << ": "
+                  << (lua_isstring(L, -1) ? lua_tostring(L, -1) : "no devuelve una tabla") << std::endl;
+        lua_pop(L, 1);
+        return;
+    }
+    int cases = lua_gettop(L);
+
+    for (int i = 1; i <= (int)lua_objlen(L, cases); ++i) {
+        lua_rawgeti(L, cases, i);
+        int c = lua_gettop(L);
+
+        lua_getfield(L, c, "name");
+        std::string name = lua_isstring(L, -1) ? lua_tostring(L, -1) : "lua_case";
+        lua_getfield(L, c, "iterations");
+        Uint64 iterations = (Uint64)luaL_optnumber(L, -1, 100000);
+        lua_getfield(L, c, "gl");
+        bool needs_gl = lua_toboolean(L, -1) != 0;
+        lua_pop(L, 3);
+
+        bool ok = true;
+        if (selected(name) && (!needs_gl || gl_ready)) {
+            lua_getfield(L, c, "setup");
+            if (lua_isfunction(L, -1)) ok = call_lua(L, 0, name.c_str());
+            else lua_pop(L, 1);
+        }
+
+        if (ok) {
+            run_bench(name, iterations, needs_gl, [L, c, &name](Uint64 n) {
+                lua_getfield(L, c, "run");
+                lua_pushnumber(L, (lua_Number)n);
+                double t0 = now_ns();
+                bool ran = call_lua(L, 1, name.c_str());
+                double elapsed = now_ns() - t0;
+                return ran ? elapsed : 0.0;
+            });
+        }
+        lua_settop(L, cases);
+    }
+    lua_pop(L, 1);
+}
+
+// ----------------------------------------------------------------------------
+// Inicialización mínima: SDL sin audio, ventana GL oculta si se puede
+// ----------------------------------------------------------------------------
+
+static void init_gl() {
+    if (!opts.gl) return;
+
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
+        std::cerr << "[BENCH] Sin vídeo: " << SDL_GetError() << std::endl;
+        return;
+    }
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+
+    engine.window = SDL_CreateWindow("xpp_bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                     INTERNAL_W, INTERNAL_H, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    if (!engine.window) {
+        std::cerr << "[BENCH] Sin ventana GL: " << SDL_GetError() << std::endl;
+        return;
+    }
+    engine.gl_context = SDL_GL_CreateContext(engine.window);
+    if (!engine.gl_context) {
+        std::cerr << "[BENCH] Sin contexto GL: " << SDL_GetError() << std::endl;
+        return;
+    }
+    SDL_GL_SetSwapInterval(0);
+    init_renderer();
+    gl_ready = true;
+}
+
+static void shutdown_gl() {
+    if (engine.gl_context) {
+        free_all_textures();
+        SDL_GL_DeleteContext(engine.gl_context);
+    }
+    if (engine.window) SDL_DestroyWindow(engine.window);
+}
+
+static void print_results(FILE* out) {
+    if (opts.json) {
+        fprintf(out, "{\n  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            fprintf(out, "    {\"name\": \"%s\", ", r.name.c_str());
+            if (!r.skipped.empty()) {
+                fprintf(out, "\"skipped\": \"%s\"}", r.skipped.c_str());
+            } else {
+                fprintf(out, "\"iterations\": %llu, \"repeat\": %d, \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f}",
+                       (unsigned long long)r.iterations, opts.repeat, r.median_ns, r.min_ns);
+            }
+            fprintf(out, "%s\n", i + 1 < results.size() ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+        return;
+    }
+
+    fprintf(out, "%-32s %12s %14s %14s\n", "benchmark", "iterations", "ns/op", "min ns/op");
+    for (const BenchResult& r : results) {
+        if (!r.skipped.empty()) {
+            fprintf(out, "%-32s %12s   (saltado: %s)\n", r.name.c_str(), "-", r.skipped.c_str());
+        } else {
+            fprintf(out, "%-32s %12llu %14.2f %14.2f\n", r.name.c_str(),
+                   (unsigned long long)r.iterations, r.median_ns, r.min_ns);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--json")) opts.json = true;
+        else if (!strcmp(argv[i], "--no-gl")) opts.gl = false;
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) opts.out = argv[++i];
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc) opts.filter = argv[++i];
+        else if (!strcmp(argv[i], "--repeat") && i + 1 < argc) opts.repeat = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--scale") && i + 1 < argc) opts.scale = std::max(0.001, atof(argv[++i]));
+        else {
+            std::cerr << "Uso: " << argv[0] << " [--json] [--out archivo] [--filter texto] [--repeat N] [--scale F] [--no-gl]" << std::endl;
+            return 1;
+        }
+    }
+
+    init_gl();
+
+    {
+        MuteCout mute;
+        engine.L = luaL_newstate();
+        luaL_openlibs(engine.L);
+        lua_atpanic(engine.L, l_panic);
+        open_engine_modules(engine.L);
+    }
+
+    bench_renderer();
+    bench_lua_state();
+    bench_lua_cases("bench/bench.lua");
+
+    lua_close(engine.L);
+    shutdown_gl();
+    SDL_Quit();
+
+    FILE* out = stdout;
+    if (!opts.out.empty()) {
+        out = fopen(opts.out.c_str(), "w");
+        if (!out) {
+            std::cerr << "[BENCH] No se pudo escribir " << opts.out << std::endl;
+            return 1;
+        }
+    }
+    print_results(out);
+    if (out != stdout) fclose(out);
+    return 0;
+}
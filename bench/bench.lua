@@ -0,0 +1,201 @@
+-- bench/bench.lua
+-- Casos Lua de bin/xpp_bench. Cada caso: name, iterations, gl (necesita
+-- contexto OpenGL), setup() opcional y run(n), que ejecuta n operaciones.
+-- El tiempo lo mide el harness en C++ alrededor de run(n).
+
+-- Los scripts del juego usan console.*; en el benchmark no hay consola
+console = console or { log = function() end, error = function(...) print(...) end }
+
+local physics = require("scripts.core.physics")
+local sched = require("scripts.core.sched")
+local activation = require("scripts.core.activation")
+local bindings = require("scripts.core.ffi_bindings")
+
+local cases = {}
+
+local function add(case)
+    cases[#cases + 1] = case
+end
+
+-- ============================================================================
+-- BINDINGS (coste de cruzar Lua -> C)
+-- ============================================================================
+
+add({
+    name = "lua_batch_draw",
+    iterations = 1000000,
+    gl = true,
+    run = function(n)
+        local draw = batch.draw
+        for i = 1, n do
+            draw(0, i % 256, 16, 16, 16, 0, 0, 1, 1)
+        end
+        batch.flush()
+    end
+})
+
+add({
+    name = "lua_input_is_down",
+    iterations = 2000000,
+    run = function(n)
+        local is_down = input.is_down
+        local hits = 0
+        for i = 1, n do
+            if is_down(29) then hits = hits + 1 end
+        end
+        return hits
+    end
+})
+
+if bindings.available then
+    add({
+        name = "ffi_batch_draw",
+        iterations = 1000000,
+        gl = true,
+        run = function(n)
+            local draw = bindings.batch.draw
+            for i = 1, n do
+                draw(0, i % 256, 16, 16, 16, 0, 0, 1, 1)
+            end
+            bindings.batch.flush()
+        end
+    })
+
+    add({
+        name = "ffi_input_is_down",
+        iterations = 2000000,
+        run = function(n)
+            local is_down = bindings.input.is_down
+            local hits = 0
+            for i = 1, n do
+                if is_down(29) then hits = hits + 1 end
+            end
+            return hits
+        end
+    })
+end
+
+-- ============================================================================
+-- FÍSICA
+-- ============================================================================
+
+-- Suelo de tiles de 16px + unas plataformas: un move_and_slide típico
+local solids = {}
+local mover
+
+add({
+    name = "physics_move_and_slide_64_solids",
+    iterations = 100000,
+    setup = function()
+        solids = {}
+        for i = 0, 47 do
+            local tile = physics.new_body(i * 16, 200, 16, 16)
+            tile.layer = physics.LAYER_WORLD
+            solids[#solids + 1] = tile
+        end
+        for i = 0, 15 do
+            local plat = physics.new_body(i * 48, 120 + (i % 3) * 20, 32, 8)
+            plat.layer = physics.LAYER_WORLD
+            solids[#solids + 1] = plat
+        end
+        mover = physics.new_body(100, 150, 16, 24)
+    end,
+    run = function(n)
+        local body = mover
+        for i = 1, n do
+            body.vx = (i % 120 < 60) and 1.5 or -1.5
+            body.vy = body.vy + 0.25
+            body:move_and_slide(solids)
+            if body.on_floor then body.vy = -4 end
+        end
+    end
+})
+
+-- Disparo rápido (24 px/frame) barriendo contra los mismos sólidos
+add({
+    name = "physics_sweep_fast_shot",
+    iterations = 100000,
+    run = function(n)
+        local shot = physics.new_body(0, 190, 8, 6)
+        for i = 1, n do
+            shot.x = (i * 24) % 768
+            physics.sweep_solids(shot, 24, 4, solids, true)
+        end
+    end
+})
+
+-- ============================================================================
+-- SCHEDULER Y ACTIVACIÓN
+-- ============================================================================
+
+-- Entidad mínima: se mueve en horizontal, como un enemigo patrullando
+local Walker = {}
+Walker.__index = Walker
+
+function Walker.new(args)
+    local self = setmetatable({}, Walker)
+    self.body = physics.new_body(args.x, args.y, 16, 16)
+    self.body.layer = physics.LAYER_ENEMY
+    self.dir = 1
+    return self
+end
+
+function Walker:update()
+    local b = self.body
+    b.x = b.x + self.dir
+    if b.x % 64 == 0 then self.dir = -self.dir end
+end
+
+local function populate(count, spread)
+    sched.clear()
+    for i = 1, count do
+        sched.spawn(Walker, { x = (i * 37) % spread, y = (i * 13) % 224 })
+    end
+    _G.camera_x, _G.camera_y = 0, 0
+    sched.update(1 / 60) -- inyecta los procesos nuevos
+end
+
+add({
+    name = "sched_update_500_visible",
+    iterations = 500,
+    setup = function() populate(500, 256) end,
+    run = function(n)
+        for _ = 1, n do sched.update(1 / 60) end
+    end
+})
+
+add({
+    name = "sched_update_5000_level",
+    iterations = 500,
+    setup = function() populate(5000, 16384) end,
+    run = function(n)
+        for _ = 1, n do sched.update(1 / 60) end
+    end
+})
+
+add({
+    name = "physics_check_entity_overlap",
+    iterations = 20000,
+    setup = function() populate(500, 256) end,
+    run = function(n)
+        local probe = physics.new_body(-100, -100, 16, 16)
+        for _ = 1, n do
+            physics.check_entity_overlap(probe, physics.LAYER_PLAYER)
+        end
+    end
+})
+
+add({
+    name = "activation_query_view",
+    iterations = 20000,
+    setup = function() populate(5000, 16384) end,
+    run = function(n)
+        local out = {}
+        for i = 1, n do
+            for k = #out, 1, -1 do out[k] = nil end
+            activation.query(-64, -64, 384, 352, out, -i)
+        end
+    end
+})
+
+return cases
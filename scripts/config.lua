@@ -4,11 +4,24 @@ config.system = {
     width = 256,
     height = 224,
     scale = 4,
-    vsync = true,
-    fps_limit = 60,
+    vsync = true,            -- true, false o "adaptive"
+    fps_limit = 60,          -- Límite cuando no hay vsync (0 = sin límite)
+    -- pacing = "capped",    -- Fuerza modo: "vsync", "adaptive", "uncapped", "capped"
+    late_input = false,      -- Leer input y simular lo más tarde posible antes de _draw
     title = "Mega Man X++ Test"
 }
 
+-- Audio. low_latency: buffer pequeño (se duplica solo si hay underruns, hasta
+-- max_buffer) y SFX colocados en la muestra exacta de su tick de update.
+config.audio = {
+    low_latency = true,
+    frequency = 44100,
+    buffer = 512,            -- Frames (512 @ 44.1 kHz = 11.6 ms; el modo clásico usa 2048)
+    max_buffer = 2048,
+    channels = 32,
+    underrun_limit = 3,      -- Underruns por segundo antes de subir el buffer
+}
+
 config.input = {
     keys = {
         up = "up", down = "down", left = "left", right = "right",
@@ -47,9 +60,29 @@ config.physics = {
     hit_knockback_y = 3.0    -- Empuje vertical al recibir daño
 }
 
+-- Regiones de activación: solo se ejecutan/dibujan las entidades dentro de
+-- la cámara + margen (px). Las que salen reciben on_sleep, las que entran on_wake.
+-- Las entidades 'transient' (disparos) se destruyen en lugar de dormirse.
+config.activation = {
+    enabled = true,
+    margin = 64,
+}
+
+-- Presupuestos de memoria en MB (0 = sin límite). Al superarlos se desalojan
+-- los assets sin referencias menos usados (texturas liberadas, SFX en silencio).
+config.memory = {
+    texture = 0,
+    sfx = 0,
+    music = 0,
+    lua = 0,
+    batch = 0,
+    level = 0,
+    bodies = 0,
+}
+
 config.debug = {
     enabled = true,
-    show_hitboxes = false
+    show_hitboxes = false   -- AABBs y contactos con debugdraw (make DEBUG_DRAW=0 lo elimina)
 }
 
 return config
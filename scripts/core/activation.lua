@@ -0,0 +1,109 @@
+-- scripts/core/activation.lua
+-- Regiones de activación: índice espacial (rejilla hash) de los procesos del
+-- scheduler para saber cuáles están cerca de la cámara sin recorrer el nivel
+-- entero. Equivale a las "ventanas de spawn" del juego original.
+local activation = {}
+
+activation.cell_size = 128
+
+local cells = {}  -- clave de celda -> { [task] = true }
+local floor = math.floor
+
+-- Clave numérica única para (cx, cy), válida con coordenadas negativas
+local function cell_key(cx, cy)
+    return (cy + 32768) * 65536 + (cx + 32768)
+end
+
+-- activation.bounds(entity) -> x, y, w, h | nil
+-- Usa entity.body si existe; si no, los campos x/y/w/h de la propia entidad.
+function activation.bounds(entity)
+    if not entity then return nil end
+    local b = entity.body or entity
+    if b.x == nil or b.y == nil then return nil end
+    return b.x, b.y, b.w or 0, b.h or 0
+end
+
+local function cell_range(x, y, w, h)
+    local cs = activation.cell_size
+    return floor(x / cs), floor(y / cs), floor((x + w) / cs), floor((y + h) / cs)
+end
+
+local function link(task, x0, y0, x1, y1)
+    for cy = y0, y1 do
+        for cx = x0, x1 do
+            local key = cell_key(cx, cy)
+            local cell = cells[key]
+            if not cell then
+                cell = {}
+                cells[key] = cell
+            end
+            cell[task] = true
+        end
+    end
+    task.cell_x0, task.cell_y0, task.cell_x1, task.cell_y1 = x0, y0, x1, y1
+end
+
+-- activation.insert(task) -> true si la entidad tiene bounds y quedó indexada
+function activation.insert(task)
+    local x, y, w, h = activation.bounds(task.entity)
+    if not x then return false end
+    link(task, cell_range(x, y, w, h))
+    return true
+end
+
+-- activation.remove(task)
+function activation.remove(task)
+    if not task.cell_x0 then return end
+    for cy = task.cell_y0, task.cell_y1 do
+        for cx = task.cell_x0, task.cell_x1 do
+            local key = cell_key(cx, cy)
+            local cell = cells[key]
+            if cell then
+                cell[task] = nil
+                if next(cell) == nil then cells[key] = nil end
+            end
+        end
+    end
+    task.cell_x0 = nil
+end
+
+-- activation.move(task)
+-- Reindexa tras moverse; solo toca la rejilla si cambió de celdas.
+function activation.move(task)
+    local x, y, w, h = activation.bounds(task.entity)
+    if not x then return end
+    local x0, y0, x1, y1 = cell_range(x, y, w, h)
+    if x0 == task.cell_x0 and y0 == task.cell_y0 and x1 == task.cell_x1 and y1 == task.cell_y1 then
+        return
+    end
+    activation.remove(task)
+    link(task, x0, y0, x1, y1)
+end
+
+-- activation.query(x, y, w, h, out, stamp)
+-- Añade a 'out' los procesos de las celdas que tocan el rectángulo.
+-- 'stamp' evita duplicados (entidades que ocupan varias celdas).
+function activation.query(x, y, w, h, out, stamp)
+    local x0, y0, x1, y1 = cell_range(x, y, w, h)
+    for cy = y0, y1 do
+        for cx = x0, x1 do
+            local cell = cells[cell_key(cx, cy)]
+            if cell then
+                for task in pairs(cell) do
+                    if task.seen ~= stamp then
+                        task.seen = stamp
+                        out[#out + 1] = task
+                    end
+                end
+            end
+        end
+    end
+    return out
+end
+
+-- activation.clear()
+function activation.clear()
+    cells = {}
+end
+
+return activation
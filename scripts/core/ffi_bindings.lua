@@ -0,0 +1,136 @@
+-- scripts/core/ffi_bindings.lua
+-- Bindings LuaJIT FFI para las llamadas calientes del motor.
+-- Las lua_CFunction clásicas (luaL_register) cortan las trazas del JIT; estas
+-- versiones llaman directamente a la ABI C exportada por el ejecutable
+-- (símbolos xpp_*, ver engine.hpp), así que los bucles de update se compilan.
+--
+-- Uso: require("scripts.core.ffi_bindings").install()
+-- Sustituye input.is_down, util.time/ticks/random y batch.draw/flush/set_camera
+-- en las tablas globales; el resto del código no cambia.
+local bindings = {}
+
+local ok, ffi = pcall(require, "ffi")
+
+bindings.available = false
+bindings.classic = {}   -- Funciones originales (fallback / benchmarks)
+bindings.input = {}
+bindings.util = {}
+bindings.batch = {}
+
+if ok then
+    -- Debe coincidir con el bloque extern "C" de src/engine.hpp
+    ffi.cdef[[
+        int xpp_input_is_down(int scancode);
+        double xpp_util_time(void);
+        uint32_t xpp_util_ticks(void);
+        double xpp_util_random(void);
+        void xpp_batch_draw(uint32_t texture, float x, float y, float w, float h,
+                            float u0, float v0, float u1, float v1,
+                            float r, float g, float b, float a, int palette);
+        void xpp_batch_flush(void);
+        void xpp_batch_set_camera(float x, float y);
+
+        typedef struct xpp_body_store_t {
+            uint32_t capacity, used, live;
+            double *x, *y, *w, *h, *vx, *vy, *sub_x, *sub_y;
+            uint32_t *layer, *mask;
+            bool *is_sensor, *on_floor, *on_ceiling, *on_wall_left, *on_wall_right, *alive;
+            uint16_t *generation;
+        } xpp_body_store_t;
+
+        xpp_body_store_t *xpp_body_store(void);
+        uint32_t xpp_body_alloc(void);
+        void xpp_body_free(uint32_t handle);
+        int xpp_body_valid(uint32_t handle);
+        void xpp_body_move_and_slide(uint32_t handle);
+        void xpp_bodies_debug_draw(float cx, float cy);
+    ]]
+
+    -- Si el ejecutable no exporta los símbolos (falta -rdynamic) nos quedamos con los clásicos
+    bindings.available = pcall(function() return ffi.C.xpp_batch_draw end)
+end
+
+-- bindings.body_store() -> puntero al almacén de cuerpos (cdata) | nil
+-- Arrays SoA de physics/body_store.cpp; scripts/core/physics.lua crea sus
+-- cuerpos sobre ellos. nil sin FFI: physics usa cuerpos tabla.
+function bindings.body_store()
+    if not bindings.available then return nil end
+    local found, store = pcall(function() return ffi.C.xpp_body_store() end)
+    return found and store or nil
+end
+
+if bindings.available then
+    local C = ffi.C
+    local floor = math.floor
+
+    function bindings.input.is_down(scancode)
+        return C.xpp_input_is_down(scancode) ~= 0
+    end
+
+    function bindings.util.time()
+        return C.xpp_util_time()
+    end
+
+    function bindings.util.ticks()
+        return C.xpp_util_ticks()
+    end
+
+    -- Misma semántica que util.random / math.random (incluido el error de intervalo vacío)
+    function bindings.util.random(m, n)
+        local r = C.xpp_util_random()
+        if not m then return r end
+        if not n then
+            if m < 1 then error("bad argument #1 to 'random' (interval is empty)", 2) end
+            return 1 + floor(r * m)
+        end
+        if m > n then error("bad argument #2 to 'random' (interval is empty)", 2) end
+        return m + floor(r * (n - m + 1))
+    end
+
+    -- Como el binding clásico: el color va completo (r, g, b, a) o no va (blanco);
+    -- un color a medias sin 'a' se ignora y con 'a' o paleta falla la conversión
+    function bindings.batch.draw(tex, x, y, w, h, u0, v0, u1, v1, r, g, b, a, palette)
+        if a == nil and palette == nil then r, g, b, a = 1, 1, 1, 1 end
+        C.xpp_batch_draw(tex, x, y, w, h, u0, v0, u1, v1, r, g, b, a, palette or -1)
+    end
+
+    function bindings.batch.flush()
+        C.xpp_batch_flush()
+    end
+
+    function bindings.batch.set_camera(x, y)
+        C.xpp_batch_set_camera(x, y)
+    end
+end
+
+-- bindings.install()
+-- Reemplaza las funciones calientes de los módulos globales por sus versiones FFI.
+-- @return: true si se instalaron, false si seguimos con los bindings clásicos
+function bindings.install()
+    if not bindings.available then return false end
+
+    for name, funcs in pairs({ input = bindings.input, util = bindings.util, batch = bindings.batch }) do
+        local target = _G[name]
+        if target then
+            bindings.classic[name] = bindings.classic[name] or {}
+            for fname, fn in pairs(funcs) do
+                if bindings.classic[name][fname] == nil then
+                    bindings.classic[name][fname] = target[fname]
+                end
+                target[fname] = fn
+            end
+        end
+    end
+    return true
+end
+
+-- bindings.uninstall()
+-- Restaura los bindings clásicos (útil para comparar rendimiento).
+function bindings.uninstall()
+    for name, funcs in pairs(bindings.classic) do
+        local target = _G[name]
+        for fname, fn in pairs(funcs) do target[fname] = fn end
+    end
+end
+
+return bindings
@@ -0,0 +1,180 @@
+-- scripts/core/level_stream.lua
+-- Niveles .xlv por chunks (módulo nativo 'xlv'): mantiene en _G.map_solids solo
+-- los sólidos de los chunks cerca de la cámara y crea/retira las entidades de
+-- sus puntos de spawn al entrar/salir chunks. La cámara llama a update() al
+-- moverse; la lectura de los vecinos ocurre en un hilo del motor.
+local level_stream = {}
+local physics = require("scripts.core.physics")
+local sched = require("scripts.core.sched")
+local rewind = require("scripts.core.rewind")
+
+level_stream.radius = 1  -- Chunks de precarga alrededor de la vista
+level_stream.info = nil
+
+local types = {}         -- "metool" -> prototipo para sched.spawn
+local chunk_bodies = {}  -- id de chunk -> { bodies }
+local chunk_spawned = {} -- id de chunk -> { [spawn_id] = pid }
+local solids = {}        -- Lista compartida como _G.map_solids
+local tileset = nil      -- { tex, w, h }
+
+-- El mapa de spawns forma parte del snapshot: tras un rewind dice qué pids
+-- restaurados pertenecen a cada chunk (ver reconcile_spawns)
+rewind.track(chunk_spawned)
+
+-- level_stream.register(type_name, proto)
+-- Asocia el "type" de las entidades del JSON con su clase.
+function level_stream.register(type_name, proto)
+    types[type_name] = proto
+end
+
+local function rebuild_solids()
+    solids = {}
+    for _, bodies in pairs(chunk_bodies) do
+        for _, body in ipairs(bodies) do
+            solids[#solids + 1] = body
+        end
+    end
+    _G.map_solids = solids
+end
+
+local function is_alive(pid)
+    local task = sched.task_map[pid]
+    return task ~= nil and task.active
+end
+
+-- Crea las entidades del chunk. Las que ya siguen vivas (restauradas por un
+-- rewind con el chunk cargado) se conservan en lugar de duplicarse.
+local function spawn_chunk(id)
+    local previous = chunk_spawned[id] or {}
+    local spawned = {}
+    for _, spawn in ipairs(xlv.chunk_spawns(id)) do
+        local proto = types[spawn.type]
+        local pid = previous[spawn.id]
+        if pid and is_alive(pid) then
+            spawned[spawn.id] = pid
+        elseif proto then
+            spawned[spawn.id] = sched.spawn(proto, { x = spawn.x, y = spawn.y })
+        else
+            console.error("level_stream: tipo de entidad desconocido '" .. spawn.type .. "'")
+        end
+    end
+    chunk_spawned[id] = spawned
+end
+
+local function load_chunk(id)
+    local bodies = {}
+    for _, s in ipairs(xlv.chunk_solids(id)) do
+        local block = physics.new_body(s.x, s.y, s.w, s.h)
+        block.layer = physics.LAYER_WORLD
+        bodies[#bodies + 1] = block
+    end
+    chunk_bodies[id] = bodies
+    spawn_chunk(id)
+end
+
+-- ¿Está la entidad del pid (por el centro de su cuerpo) en un chunk residente?
+local function in_resident_chunk(pid)
+    local entity = sched.get_entity(pid)
+    local body = entity and entity.body
+    if not body or not is_alive(pid) then return false end
+    local info = level_stream.info
+    local cx = math.floor((body.x + body.w * 0.5) / info.chunk_size)
+    local cy = math.floor((body.y + body.h * 0.5) / info.chunk_size)
+    if cx < 0 or cy < 0 or cx >= info.chunks_x or cy >= info.chunks_y then return false end
+    return chunk_bodies[cy * info.chunks_x + cx] ~= nil
+end
+
+-- Al salir el chunk sus enemigos se retiran sin on_destroy (reaparecen si se
+-- vuelve, estilo clásico). Los que caminaron hasta un chunk que sigue
+-- residente se quedan en el mapa de su chunk de origen: spawn_chunk los adopta
+-- si este se recarga y update los retira cuando su chunk actual también sale.
+local function unload_chunk(id)
+    chunk_bodies[id] = nil
+    local kept = nil
+    for spawn_id, pid in pairs(chunk_spawned[id] or {}) do
+        if in_resident_chunk(pid) then
+            kept = kept or {}
+            kept[spawn_id] = pid
+        else
+            sched.despawn(pid)
+        end
+    end
+    chunk_spawned[id] = kept
+end
+
+-- Tras un rewind (o al salir chunks): chunk_spawned puede tener entradas de
+-- chunks no residentes, que retiran sus entidades salvo las que sigan dentro de
+-- un chunk residente. Tras un rewind, además, los residentes sin entrada
+-- (cargados después del snapshot, cuyos enemigos borró sched.restore) vuelven
+-- a crear las suyas. Los enemigos muertos
+-- antes del snapshot siguen muertos: su pid sigue en el mapa.
+local function reconcile_spawns()
+    for id in pairs(chunk_spawned) do
+        if not chunk_bodies[id] then unload_chunk(id) end
+    end
+    for id in pairs(chunk_bodies) do
+        if not chunk_spawned[id] then spawn_chunk(id) end
+    end
+end
+
+-- level_stream.load(path) -> info | nil
+function level_stream.load(path)
+    level_stream.unload()
+
+    local info, err = xlv.open(path)
+    if not info then
+        console.error("level_stream: " .. tostring(err) .. " (" .. path .. ")")
+        return nil
+    end
+    level_stream.info = info
+
+    if info.tileset ~= "" and info.layers > 0 then
+        local tex, w, h = texture.load(info.tileset)
+        if tex then tileset = { tex = tex, w = w, h = h } end
+    end
+
+    rebuild_solids()
+    return info
+end
+
+-- level_stream.unload()
+function level_stream.unload()
+    if not level_stream.info then return end
+    -- Sin chunks residentes unload_chunk retira todas las entidades
+    for id in pairs(chunk_bodies) do chunk_bodies[id] = nil end
+    for id in pairs(chunk_spawned) do unload_chunk(id) end
+    if tileset then texture.release(tileset.tex) end
+    tileset = nil
+    xlv.close()
+    level_stream.info = nil
+    rebuild_solids()
+end
+
+-- level_stream.update(cam_x, cam_y)
+-- Una vez por frame (Camera:update). Barato si no cambió ningún chunk.
+function level_stream.update(cam_x, cam_y)
+    if not level_stream.info then return end
+
+    local loaded, unloaded = xlv.update(cam_x, cam_y, level_stream.radius)
+    for _, id in ipairs(unloaded) do unload_chunk(id) end
+    for _, id in ipairs(loaded) do load_chunk(id) end
+
+    -- Un rewind restaura su propia copia de map_solids: volvemos a la nuestra
+    -- y reconciliamos los spawns restaurados con los chunks residentes. Al
+    -- salir chunks también: retira a quienes quedaron fuera de los residentes
+    if #unloaded > 0 or _G.map_solids ~= solids then reconcile_spawns() end
+    if #loaded > 0 or #unloaded > 0 or _G.map_solids ~= solids then
+        rebuild_solids()
+    end
+end
+
+-- level_stream.draw(cx, cy)
+-- Capas de tiles (si el nivel trae tileset) en coordenadas de pantalla.
+function level_stream.draw(cx, cy)
+    if not level_stream.info or not tileset then return end
+    for layer = 0, level_stream.info.layers - 1 do
+        xlv.draw_tiles(tileset.tex, tileset.w, tileset.h, layer, cx or 0, cy or 0)
+    end
+end
+
+return level_stream
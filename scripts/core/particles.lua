@@ -41,8 +41,8 @@ if self.life <= 0 then
     -- Simular opacidad con parpadeo si queda poca vida (estilo retro)
     if self.life < 10 and (self.life % 2 == 0) then return end
 
-        -- Usamos textura blanca (asumiendo que texture.white() existe y funciona)
-        batch.draw(texture.white(), self.x, self.y, 0, 0, self.w, self.h, false)
+        -- Textura blanca 1x1 escalada al tamaño de la partícula
+        batch.draw(texture.white(), self.x, self.y, self.w, self.h, 0, 0, 1, 1)
         end
 
         -- Generador de Explosión de Muerte (4 orbes saliendo en diagonal)
@@ -68,8 +68,8 @@ if self.life <= 0 then
             -- Generador de Chispas (Hit effect)
             function particles.spawn_hit(x, y)
             for i=1, 4 do
-                local vx = math.random(-20, 20) / 10.0
-                local vy = math.random(-20, 20) / 10.0
+                local vx = util.random(-20, 20) / 10.0
+                local vy = util.random(-20, 20) / 10.0
                 sched.spawn(Particle, {
                     x = x, y = y,
                     vx = vx, vy = vy,
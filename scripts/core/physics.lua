@@ -20,9 +20,12 @@ physics.LAYER_TRIGGER     = 64 -- Puertas, zonas de muerte, eventos
 local Body = {}
 Body.__index = Body
 
+-- Cuerpo en el almacén nativo (sección 6); nil sin FFI o con el almacén lleno
+local new_store_body
+
 -- Constructor
 function physics.new_body(x, y, w, h)
-local self = setmetatable({}, Body)
+local self = new_store_body() or setmetatable({}, Body)
 
 -- Posición y Dimensiones (AABB)
 self.x = x or 0
@@ -116,44 +119,42 @@ if(self.sub_x >= 1.0) then
                 self.on_wall_right = false
 
                 -- 2. MOVER EJE X
-                self.x = self.x + dx
-
-                -- Resolución de colisiones X
-                if(not self.is_sensor) then
-                    for _, solid in ipairs(solids) do
-                        if(self:check_collision(solid)) then
-                            -- Determinar dirección de colisión
-                            if(dx > 0) then -- Moviendo derecha
-                                self.x = solid.x - self.w -- Pegar al borde izquierdo del obstáculo
-                                self.on_wall_right = true
-                                elseif(dx < 0) then -- Moviendo izquierda
-                                    self.x = solid.x + solid.w -- Pegar al borde derecho del obstáculo
-                                    self.on_wall_left = true
-                                    end
-                                    self.vx = 0 -- Detener velocidad X
-                                    end
-                                    end
-                                    end
+                -- Barrido: el primer sólido en el trayecto detiene al cuerpo, así que no hay
+                -- túnel aunque dx supere el grosor de la plataforma (dash, proyectiles rápidos)
+                local hit = nil
+                if(dx ~= 0 and not self.is_sensor) then
+                    hit = physics.sweep_solids(self, dx, 0, solids)
+                end
+                if(hit) then
+                    if(dx > 0) then -- Moviendo derecha
+                        self.x = hit.x - self.w -- Pegar al borde izquierdo del obstáculo
+                        self.on_wall_right = true
+                    else -- Moviendo izquierda
+                        self.x = hit.x + hit.w -- Pegar al borde derecho del obstáculo
+                        self.on_wall_left = true
+                    end
+                    self.vx = 0 -- Detener velocidad X
+                else
+                    self.x = self.x + dx
+                end
 
                                     -- 3. MOVER EJE Y
-                                    self.y = self.y + dy
-
-                                    -- Resolución de colisiones Y
-                                    if(not self.is_sensor) then
-                                        for _, solid in ipairs(solids) do
-                                            if(self:check_collision(solid)) then
-                                                if(dy > 0) then -- Cayendo (Suelo)
-                                                    self.y = solid.y - self.h
-                                                    self.on_floor = true
-                                                    self.vy = 0
-                                                    elseif(dy < 0) then -- Saltando (Techo)
-                                                        self.y = solid.y + solid.h
-                                                        self.on_ceiling = true
-                                                        self.vy = 0
-                                                        end
-                                                        end
-                                                        end
-                                                        end
+                                    hit = nil
+                                    if(dy ~= 0 and not self.is_sensor) then
+                                        hit = physics.sweep_solids(self, 0, dy, solids)
+                                    end
+                                    if(hit) then
+                                        if(dy > 0) then -- Cayendo (Suelo)
+                                            self.y = hit.y - self.h
+                                            self.on_floor = true
+                                        else -- Saltando (Techo)
+                                            self.y = hit.y + hit.h
+                                            self.on_ceiling = true
+                                        end
+                                        self.vy = 0
+                                    else
+                                        self.y = self.y + dy
+                                    end
                                                         end
 
                                                         -- Helpers de Debug
@@ -170,8 +171,8 @@ if(self.sub_x >= 1.0) then
                                                         function physics.check_entity_overlap(self_body, target_layer)
                                                         local sched = require("scripts.core.sched")
 
-                                                        -- Recorrer todas las tareas activas
-                                                        for _, task in ipairs(sched.tasks) do
+                                                        -- Recorrer solo las tareas despiertas (cerca de la cámara)
+                                                        for _, task in ipairs(sched.active_tasks) do
                                                             if task.active and task.entity and task.entity.body then
                                                                 local other = task.entity.body
 
@@ -189,4 +190,216 @@ if(self.sub_x >= 1.0) then
                                                                         return nil
                                                                         end
 
-                                                                        return physics
+-- ============================================================================
+-- 4. DEBUG DRAW (HITBOXES Y CONTACTOS)
+-- ============================================================================
+
+-- Color por capa (r, g, b)
+local layer_colors = {
+    [physics.LAYER_WORLD]       = {0.2, 0.9, 0.2},
+    [physics.LAYER_PLAYER]      = {0.2, 0.8, 1.0},
+    [physics.LAYER_ENEMY]       = {1.0, 0.25, 0.25},
+    [physics.LAYER_PLAYER_SHOT] = {1.0, 1.0, 0.3},
+    [physics.LAYER_ENEMY_SHOT]  = {1.0, 0.6, 0.1},
+    [physics.LAYER_ITEM]        = {1.0, 0.3, 1.0},
+    [physics.LAYER_TRIGGER]     = {0.4, 0.4, 1.0},
+}
+local default_color = {1, 1, 1}
+
+local function draw_body(body, cx, cy)
+    local c = layer_colors[body.layer] or default_color
+    local x, y = body.x - cx, body.y - cy
+    -- Los sensores se dibujan más tenues: detectan pero no empujan
+    debugdraw.outline(x, y, body.w, body.h, c[1], c[2], c[3], body.is_sensor and 0.5 or 1)
+
+    -- Contactos del último move_and_slide: arista resaltada en rojo
+    if body.on_floor then debugdraw.line(x, y + body.h, x + body.w, y + body.h, 1, 0, 0, 1) end
+    if body.on_ceiling then debugdraw.line(x, y, x + body.w, y, 1, 0, 0, 1) end
+    if body.on_wall_left then debugdraw.line(x, y, x, y + body.h, 1, 0, 0, 1) end
+    if body.on_wall_right then debugdraw.line(x + body.w, y, x + body.w, y + body.h, 1, 0, 0, 1) end
+
+    -- Centro + vector velocidad (x8 para que se vea)
+    if body.vx ~= 0 or body.vy ~= 0 then
+        local mx, my = x + body.w / 2, y + body.h / 2
+        debugdraw.cross(mx, my, 3, 1, 1, 1, 1)
+        debugdraw.line(mx, my, mx + body.vx * 8, my + body.vy * 8, 1, 1, 1, 0.8)
+    end
+end
+
+-- physics.debug_draw(cx, cy)
+-- Dibuja los AABB de los sólidos del mapa y de las entidades despiertas.
+-- Con el debug draw apagado (config.debug.show_hitboxes = false o DEBUG_DRAW=0)
+-- vuelve sin recorrer nada.
+function physics.debug_draw(cx, cy)
+    if not debugdraw or not debugdraw.enabled() then return end
+    cx = cx or _G.camera_x or 0
+    cy = cy or _G.camera_y or 0
+
+    -- Los cuerpos del almacén nativo se dibujan en un solo pase C (con culling);
+    -- aquí solo quedan los cuerpos tabla
+    physics.debug_draw_store(cx, cy)
+
+    for _, solid in ipairs(_G.map_solids or {}) do
+        if type(solid) == "table" then draw_body(solid, cx, cy) end
+    end
+
+    local sched = require("scripts.core.sched")
+    for _, task in ipairs(sched.active_tasks) do
+        local body = task.active and task.entity and task.entity.body
+        if type(body) == "table" then
+            draw_body(body, cx, cy)
+        end
+    end
+end
+
+-- ============================================================================
+-- 5. COLISIÓN CONTINUA (BARRIDOS NATIVOS, módulo 'collide')
+-- ============================================================================
+
+-- Lista de sólidos copiada al motor. Se vuelve a copiar sola si cambia la tabla
+-- (nivel nuevo, chunks, rewind) o su tamaño; si se mueve un sólido en su sitio,
+-- llamar a physics.invalidate_solids().
+local synced_solids = nil
+local synced_count = -1
+
+function physics.invalidate_solids()
+    synced_solids = nil
+end
+
+local function sync_solids(solids)
+    if solids ~= synced_solids or #solids ~= synced_count then
+        collide.set_solids(solids)
+        synced_solids = solids
+        synced_count = #solids
+    end
+end
+
+-- physics.sweep_solids(body, dx, dy, solids, [hit_overlap]) -> solid, t, nx, ny
+-- Primer sólido de la lista que toca el AABB del cuerpo al desplazarse (dx, dy).
+-- t es la fracción del desplazamiento hasta el contacto; nil si no toca nada.
+function physics.sweep_solids(body, dx, dy, solids, hit_overlap)
+    sync_solids(solids)
+    local t, nx, ny, index = collide.sweep(body.x, body.y, body.w, body.h, dx, dy, hit_overlap)
+    if not index then return nil, 1 end
+    return solids[index], t, nx, ny
+end
+
+-- Candidatos dinámicos reutilizados entre llamadas (sin basura por frame)
+local cand_bodies = {}
+local cand_entities = {}
+
+-- physics.sweep(body, dx, dy, solids, target_layer) -> t, solid, entity, nx, ny
+-- Barrido contra el mundo y las entidades despiertas de target_layer (en su
+-- posición actual). Gana el contacto más temprano; en empate, el mundo. Un
+-- cuerpo que ya empieza solapado choca en t = 0 (disparo a quemarropa).
+function physics.sweep(body, dx, dy, solids, target_layer)
+    local solid, t, nx, ny = physics.sweep_solids(body, dx, dy, solids, true)
+
+    if target_layer then
+        local sched = require("scripts.core.sched")
+        local n = 0
+        for _, task in ipairs(sched.active_tasks) do
+            local ent = task.entity
+            if task.active and ent and ent.body and ent.body ~= body and ent.body.layer == target_layer then
+                n = n + 1
+                cand_bodies[n] = ent.body
+                cand_entities[n] = ent
+            end
+        end
+        for i = #cand_bodies, n + 1, -1 do
+            cand_bodies[i] = nil
+            cand_entities[i] = nil
+        end
+
+        if n > 0 then
+            local et, enx, eny, index = collide.sweep_bodies(body.x, body.y, body.w, body.h, dx, dy, cand_bodies, true)
+            if index and (not solid or et < t) then
+                return et, nil, cand_entities[index], enx, eny
+            end
+        end
+    end
+
+    if solid then return t, solid, nil, nx, ny end
+    return 1, nil, nil, 0, 0
+end
+
+-- ============================================================================
+-- 6. ALMACÉN NATIVO DE CUERPOS (FFI)
+-- ============================================================================
+-- Con LuaJIT FFI, physics.new_body devuelve un proxy (slot + handle) sobre los
+-- arrays SoA de src/physics/body_store.cpp: body.x lee/escribe directamente la
+-- memoria del motor, sin tabla por cuerpo. move_and_slide y el debug draw corren
+-- en C sobre los mismos arrays. El slot se libera cuando el GC recoge el proxy
+-- (los snapshots del rewind lo retienen solo mientras siguen en el anillo).
+-- Sin FFI (o con el almacén lleno) los cuerpos siguen siendo tablas.
+
+local store = require("scripts.core.ffi_bindings").body_store()
+
+new_store_body = function() return nil end
+physics.debug_draw_store = function() end
+physics.body_store = store
+
+if store then
+    local ffi = require("ffi")
+    local C = ffi.C
+
+    -- Nombre de campo -> array del almacén (punteros estables: capacidad fija)
+    local fields = {
+        x = store.x, y = store.y, w = store.w, h = store.h,
+        vx = store.vx, vy = store.vy, sub_x = store.sub_x, sub_y = store.sub_y,
+        layer = store.layer, mask = store.mask,
+        is_sensor = store.is_sensor,
+        on_floor = store.on_floor, on_ceiling = store.on_ceiling,
+        on_wall_left = store.on_wall_left, on_wall_right = store.on_wall_right,
+    }
+
+    -- Métodos: los de Body (leen self.x etc. a través del proxy) + versiones nativas
+    local StoreBody = setmetatable({}, { __index = Body })
+
+    function StoreBody:move_and_slide(solids)
+        sync_solids(solids)
+        C.xpp_body_move_and_slide(self.handle)
+    end
+
+    local BodyRef = ffi.metatype("struct { uint32_t slot; uint32_t handle; }", {
+        __index = function(self, key)
+            local arr = fields[key]
+            if arr then return arr[self.slot] end
+            return StoreBody[key]
+        end,
+        __newindex = function(self, key, value)
+            local arr = fields[key]
+            if not arr then error("campo de cuerpo desconocido: " .. tostring(key), 2) end
+            arr[self.slot] = value
+        end,
+    })
+
+    local function free_body(ref)
+        C.xpp_body_free(ref.handle)
+    end
+
+    local warned_full = false
+
+    new_store_body = function()
+        local handle = C.xpp_body_alloc()
+        if handle == 0 and not warned_full then
+            -- Puede haber proxies inalcanzables sin finalizar: un ciclo completo
+            -- ejecuta sus ffi.gc y devuelve los slots (una vez por llenado)
+            collectgarbage()
+            handle = C.xpp_body_alloc()
+            if handle == 0 then
+                warned_full = true
+                console.error("physics: almacén de cuerpos lleno (" .. store.capacity .. "), usando cuerpos tabla")
+            end
+        end
+        if handle == 0 then return nil end
+        warned_full = false
+        return ffi.gc(BodyRef(handle % 65536, handle), free_body)
+    end
+
+    function physics.debug_draw_store(cx, cy)
+        C.xpp_bodies_debug_draw(cx, cy)
+    end
+end
+
+return physics
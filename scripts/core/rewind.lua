@@ -0,0 +1,108 @@
+-- scripts/core/rewind.lua
+-- Rewind / reintento instantáneo sobre el módulo nativo 'snapshot'.
+-- Captura scheduler + mundo + singletons registrados una vez por segundo en un
+-- anillo (deltas comprimidos en C++) y permite volver atrás en un solo frame.
+local rewind = {}
+local sched = require("scripts.core.sched")
+local config = require("scripts.config")
+
+-- Tablas que se restauran "en su sitio" (otros módulos guardan la referencia)
+local tracked = {}
+local recording = false
+local generation = 0 -- Invalida grabadores viejos tras stop/start
+local frame_counter = 0
+
+rewind.interval = 60 -- Frames entre capturas (1 por segundo)
+
+-- Config y módulos no cambian en juego: se guardan por referencia, no se copian
+snapshot.share(config)
+
+-- rewind.track(tbl)
+-- Registra un singleton (ej: la cámara) cuyo contenido forma parte del snapshot.
+function rewind.track(tbl)
+    table.insert(tracked, tbl)
+end
+
+-- rewind.capture() -> id | nil, err
+function rewind.capture()
+    local singletons = {}
+    for i, tbl in ipairs(tracked) do
+        local copy = {}
+        for k, v in pairs(tbl) do copy[k] = v end
+        singletons[i] = copy
+    end
+
+    return snapshot.capture({
+        sched = sched.save(),
+        map_solids = _G.map_solids,
+        player_instance = _G.player_instance,
+        camera_x = _G.camera_x,
+        camera_y = _G.camera_y,
+        singletons = singletons
+    })
+end
+
+-- rewind.restore(id) -> true | false, err
+function rewind.restore(id)
+    local root, err = snapshot.restore(id)
+    if not root then return false, err end
+
+    sched.restore(root.sched)
+    _G.map_solids = root.map_solids
+    _G.player_instance = root.player_instance
+    _G.camera_x = root.camera_x
+    _G.camera_y = root.camera_y
+
+    for i, tbl in ipairs(tracked) do
+        local saved = root.singletons[i]
+        if saved then
+            for k in pairs(tbl) do tbl[k] = nil end
+            for k, v in pairs(saved) do tbl[k] = v end
+        end
+    end
+
+    -- sched.restore descarta los procesos función: relanzamos el grabador
+    if recording then
+        recording = false
+        rewind.start()
+    end
+    return true
+end
+
+-- rewind.retry(seconds_back) -> true | false, err
+-- Vuelve al snapshot de hace 'seconds_back' capturas (0 = la más reciente).
+function rewind.retry(seconds_back)
+    local oldest, newest = snapshot.range()
+    if not oldest then return false, "no snapshots" end
+    local id = math.max(oldest, newest - (seconds_back or 0))
+    return rewind.restore(id)
+end
+
+-- rewind.start()
+-- Lanza el proceso que captura cada 'rewind.interval' frames.
+function rewind.start()
+    if recording then return end
+    recording = true
+    generation = generation + 1
+    frame_counter = 0
+
+    local my_generation = generation
+    sched.spawn(function()
+        while recording and my_generation == generation do
+            frame_counter = frame_counter + 1
+            if frame_counter >= rewind.interval then
+                frame_counter = 0
+                rewind.capture()
+            end
+            coroutine.yield()
+        end
+    end)
+end
+
+-- rewind.stop([clear])
+function rewind.stop(clear)
+    recording = false
+    if clear then snapshot.clear() end
+end
+
+return rewind
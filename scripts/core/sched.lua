@@ -1,5 +1,7 @@
 local sched = {}
 local util = require("scripts.core.util")
+local config = require("scripts.config")
+local activation = require("scripts.core.activation")
 
 -- ============================================================================
 -- ESTADO INTERNO
@@ -7,6 +9,12 @@ local util = require("scripts.core.util")
 sched.tasks = {}        -- Lista de procesos activos (para iterar)
 sched.task_map = {}     -- Mapa PID -> Proceso (para búsqueda rápida)
 sched.new_tasks = {}    -- Buffer de procesos creados durante un frame
+sched.active_tasks = {} -- Procesos despiertos este frame (ordenados por capa)
+
+local always_tasks = {} -- Procesos sin bounds: se ejecutan siempre
+local transient_tasks = {} -- Entidades efímeras: mueren al salir de la vista
+local dead_tasks = {}   -- Procesos muertos pendientes de retirar
+local stamp = 0         -- Marca de frame para las consultas de activación
 
 local next_pid = 1
 
@@ -14,6 +22,20 @@ local next_pid = 1
 -- GESTIÓN DE PROCESOS
 -- ============================================================================
 
+-- Corrutina de una entidad: _init opcional y luego update() una vez por frame.
+-- @param run_init: false al restaurar un snapshot (la entidad ya se inicializó)
+local function entity_coroutine(entity, run_init)
+    return coroutine.create(function()
+        if(run_init and entity._init) then entity:_init() end
+
+        -- Ciclo de vida
+        while(true) do
+            if(entity.update) then entity:update() end
+            coroutine.yield() -- Esperar al siguiente frame
+        end
+    end)
+end
+
 -- sched.spawn(class_or_func, args)
 -- Crea un nuevo proceso/entidad y lo pone en cola.
 -- @param proto: Puede ser una Clase (tabla con :update) o una Función.
@@ -36,16 +58,7 @@ if(type(proto) == "table") then
             name = entity.name or "obj"
 
             -- Crear Corrutina: Bucle infinito llamando a update()
-            co = coroutine.create(function()
-            -- Inicialización opcional
-            if(entity._init) then entity:_init() end
-
-                -- Ciclo de vida
-                while(true) do
-                    if(entity.update) then entity:update() end
-                        coroutine.yield() -- Esperar al siguiente frame
-                        end
-                        end)
+            co = entity_coroutine(entity, true)
 
             -- CASO 2: Prototipo es una Función (Script simple)
             elseif(type(proto) == "function") then
@@ -74,6 +87,8 @@ if(type(proto) == "table") then
                         layer = (entity and entity.layer) or 0 -- Orden de dibujado
                     }
 
+                    if(entity) then entity.pid = pid end
+
                     -- Encolar para el siguiente ciclo (evita modificar lista mientras iteramos)
                     table.insert(sched.new_tasks, task)
 
@@ -83,98 +98,267 @@ if(type(proto) == "table") then
                     return pid, entity
                     end
 
-                    -- sched.kill(pid)
-                    -- Marca un proceso para ser eliminado.
-                    function sched.kill(pid)
-                    local task = sched.task_map[pid]
-                    if(task) then
-                        task.active = false
-                        if(task.entity and task.entity.on_destroy) then
-                            task.entity:on_destroy()
-                            end
-                            end
-                            end
-
-                            -- sched.get_entity(pid)
-                            -- Recupera la entidad asociada a un PID.
-                            function sched.get_entity(pid)
-                            local task = sched.task_map[pid]
-                            return (task and task.entity) or nil
-                            end
-
-                            -- ============================================================================
-                            -- BUCLE PRINCIPAL (SYSTEM LOOP)
-                            -- ============================================================================
-
-                            -- sched.update(dt)
-                            -- Avanza la lógica de todos los procesos activos.
-                            function sched.update(dt)
-                            -- 1. Inyectar nuevos procesos al pool principal
-                            if(#sched.new_tasks > 0) then
-                                for i, task in ipairs(sched.new_tasks) do
-                                    table.insert(sched.tasks, task)
-                                    end
-                                    sched.new_tasks = {}
-
-                                    -- Reordenar por capa (Z-Index) para el dibujado correcto
-                                    -- (Optimizacion: Hacer esto solo si hay cambios de layer, pero por ahora en spawn)
-                                    table.sort(sched.tasks, function(a, b) return a.layer < b.layer end)
-                                    end
-
-                                    -- 2. Ejecutar procesos
-                                    local alive_count = 0
-                                    local i = 1
-
-                                    while(i <= #sched.tasks) do
-                                        local task = sched.tasks[i]
-
-                                        if(task.active and coroutine.status(task.co) ~= "dead") then
-                                            -- Inyectar 'dt' globales o locales si es necesario
-                                            -- (Por diseño MMX++ usa fixed timestep lógico, pero pasamos dt real por si acaso)
-
-                                            local status, err = coroutine.resume(task.co, dt)
-
-                                            if(not status) then
-                                                -- Error en el script del objeto
-                                                console.error("Runtime Error (PID " .. task.pid .. "): " .. tostring(err))
-                                                -- Opcional: Matar proceso para no spammear error
-                                                task.active = false
-                                                end
-
-                                                i = i + 1
-                                                else
-                                                    -- Limpieza de cadáveres (Garbage Collection del Scheduler)
-                                                    sched.task_map[task.pid] = nil
-                                                    table.remove(sched.tasks, i)
-                                                    end
-                                                    end
-                                                    end
-
-                                                    -- sched.draw()
-                                                    -- Dibuja todos los procesos que tengan componente visual.
-                                                    -- scripts/core/sched.lua
-
-                                                    -- ... (código anterior)
-
-                                                    function sched.draw()
-                                                    -- Obtenemos cámara global
-                                                    local cx = _G.camera_x or 0
-                                                    local cy = _G.camera_y or 0
-
-                                                    for _, task in ipairs(sched.tasks) do
-                                                        if(task.active and task.entity and task.entity.draw) then
-                                                            task.entity:draw(cx, cy)
-                                                            end
-                                                            end
-                                                            end
-
-                                                            -- sched.clear()
-                                                            -- Elimina todos los procesos (ej: cambio de nivel)
-                                                            function sched.clear()
-                                                            sched.tasks = {}
-                                                            sched.task_map = {}
-                                                            sched.new_tasks = {}
-                                                            -- Nota: No reseteamos next_pid para evitar colisiones con referencias viejas
-                                                            end
+-- sched.kill(pid)
+-- Marca un proceso para ser eliminado (se retira al final del próximo update,
+-- aunque esté dormido fuera de la cámara).
+function sched.kill(pid)
+    local task = sched.task_map[pid]
+    if(task and task.active) then
+        task.active = false
+        table.insert(dead_tasks, task)
+        if(task.entity and task.entity.on_destroy) then
+            task.entity:on_destroy()
+        end
+    end
+end
+
+-- Retira un proceso que terminó (o falló) sin on_destroy: la entidad no fue destruida
+local function retire(task)
+    task.active = false
+    table.insert(dead_tasks, task)
+end
+
+-- sched.despawn(pid)
+-- Como kill pero sin on_destroy: la entidad sale de escena (p. ej. su chunk
+-- dejó de estar residente), no fue destruida.
+function sched.despawn(pid)
+    local task = sched.task_map[pid]
+    if(task and task.active) then retire(task) end
+end
+
+-- sched.get_entity(pid)
+-- Recupera la entidad asociada a un PID.
+function sched.get_entity(pid)
+    local task = sched.task_map[pid]
+    return (task and task.entity) or nil
+end
+
+-- ============================================================================
+-- REGIONES DE ACTIVACIÓN
+-- ============================================================================
+
+-- Rectángulo de vista (cámara + margen) o nil si no hay cámara / está desactivado
+local function view_rect()
+    local cfg = config.activation
+    if(not cfg or not cfg.enabled or _G.camera_x == nil) then return nil end
+    local m = cfg.margin or 0
+    return _G.camera_x - m, (_G.camera_y or 0) - m,
+           config.system.width + m * 2, config.system.height + m * 2
+end
+
+local function by_layer(a, b)
+    if(a.layer ~= b.layer) then return a.layer < b.layer end
+    return a.pid < b.pid
+end
+
+-- Incorpora los procesos nuevos: con bounds van a la rejilla, sin bounds
+-- (funciones, entidades always_active) se ejecutan siempre.
+local function inject_new_tasks()
+    for _, task in ipairs(sched.new_tasks) do
+        if(task.active) then
+            table.insert(sched.tasks, task)
+            local entity = task.entity
+            if(entity and entity.always_active) or not activation.insert(task) then
+                table.insert(always_tasks, task)
+            elseif(entity and entity.transient) then
+                table.insert(transient_tasks, task)
+            end
+        end
+    end
+    sched.new_tasks = {}
+end
+
+-- Construye sched.active_tasks (ordenada por capa) y dispara on_wake / on_sleep
+local function collect_active()
+    stamp = stamp + 1
+    local previous = sched.active_tasks
+    local active = {}
+
+    local x, y, w, h = view_rect()
+    if(x) then
+        for _, task in ipairs(always_tasks) do
+            task.seen = stamp
+            active[#active + 1] = task
+        end
+        activation.query(x, y, w, h, active, stamp)
+    else
+        for _, task in ipairs(sched.tasks) do
+            task.seen = stamp
+            active[#active + 1] = task
+        end
+    end
+    table.sort(active, by_layer)
+
+    for _, task in ipairs(active) do
+        if(not task.awake) then
+            task.awake = true
+            if(task.entity and task.entity.on_wake) then task.entity:on_wake() end
+        end
+    end
+    for _, task in ipairs(previous) do
+        if(task.seen ~= stamp and task.awake) then
+            task.awake = false
+            if(task.active and task.entity and task.entity.on_sleep) then task.entity:on_sleep() end
+        end
+    end
+
+    sched.active_tasks = active
+
+    -- Efímeros fuera de la vista (también los creados ya fuera): se destruyen
+    if(x) then
+        for _, task in ipairs(transient_tasks) do
+            if(task.seen ~= stamp) then sched.kill(task.pid) end
+        end
+    end
+end
+
+-- Retira los procesos muertos de todas las estructuras
+local function remove_dead()
+    if(#dead_tasks == 0) then return end
+
+    local dead = {}
+    for _, task in ipairs(dead_tasks) do
+        dead[task] = true
+        activation.remove(task)
+        if(sched.task_map[task.pid] == task) then sched.task_map[task.pid] = nil end
+    end
+    dead_tasks = {}
+
+    local function compact(list)
+        local j = 1
+        for i = 1, #list do
+            local task = list[i]
+            if(not dead[task]) then
+                list[j] = task
+                j = j + 1
+            end
+        end
+        for i = #list, j, -1 do list[i] = nil end
+    end
+    compact(sched.tasks)
+    compact(always_tasks)
+    compact(transient_tasks)
+    compact(sched.active_tasks)
+end
+
+-- ============================================================================
+-- BUCLE PRINCIPAL (SYSTEM LOOP)
+-- ============================================================================
+
+-- sched.update(dt)
+-- Avanza la lógica de los procesos activos: los que están dentro de la vista
+-- (cámara + config.activation.margin) y los que no tienen bounds. El coste
+-- escala con lo que hay cerca de la cámara, no con la población del nivel.
+function sched.update(dt)
+    -- 1. Inyectar nuevos procesos al pool principal
+    if(#sched.new_tasks > 0) then inject_new_tasks() end
+
+    -- 2. Decidir quién está despierto este frame
+    collect_active()
+
+    -- 3. Ejecutar procesos
+    for _, task in ipairs(sched.active_tasks) do
+        if(task.active) then
+            -- (Por diseño MMX++ usa fixed timestep lógico, pero pasamos dt real por si acaso)
+            local status, err = coroutine.resume(task.co, dt)
+
+            if(not status) then
+                -- Error en el script del objeto
+                console.error("Runtime Error (PID " .. task.pid .. "): " .. tostring(err))
+                -- Retirar proceso para no spammear error
+                retire(task)
+            elseif(coroutine.status(task.co) == "dead") then
+                retire(task)
+            elseif(task.cell_x0) then
+                activation.move(task)
+            end
+        end
+    end
+
+    -- 4. Limpieza de cadáveres (Garbage Collection del Scheduler)
+    remove_dead()
+end
+
+-- sched.draw()
+-- Dibuja los procesos despiertos que tengan componente visual.
+function sched.draw()
+    -- Obtenemos cámara global
+    local cx = _G.camera_x or 0
+    local cy = _G.camera_y or 0
+
+    for _, task in ipairs(sched.active_tasks) do
+        if(task.active and task.entity and task.entity.draw) then
+            task.entity:draw(cx, cy)
+        end
+    end
+
+    -- Hitboxes encima de los sprites (el debug draw se dibuja tras el batch)
+    if(debugdraw and debugdraw.enabled()) then
+        require("scripts.core.physics").debug_draw(cx, cy)
+    end
+end
+
+-- sched.clear()
+-- Elimina todos los procesos (ej: cambio de nivel)
+function sched.clear()
+    sched.tasks = {}
+    sched.task_map = {}
+    sched.new_tasks = {}
+    sched.active_tasks = {}
+    always_tasks = {}
+    transient_tasks = {}
+    dead_tasks = {}
+    activation.clear()
+    -- Nota: No reseteamos next_pid para evitar colisiones con referencias viejas
+end
+
+-- ============================================================================
+-- SNAPSHOTS (REWIND)
+-- ============================================================================
+
+-- sched.save()
+-- Estado serializable del scheduler (sin corrutinas).
+-- Los procesos de tipo función no se pueden guardar: su estado vive
+-- dentro de la corrutina, así que se descartan.
+function sched.save()
+    local saved = {}
+    local function add(task, pending_init)
+        if task.entity and task.active and coroutine.status(task.co) ~= "dead" then
+            table.insert(saved, {
+                pid = task.pid,
+                entity = task.entity,
+                name = task.name,
+                layer = task.layer,
+                pending_init = pending_init -- Aún no corrió su _init
+            })
+        end
+    end
+    for _, task in ipairs(sched.tasks) do add(task, false) end
+    for _, task in ipairs(sched.new_tasks) do add(task, true) end
+
+    return { next_pid = next_pid, tasks = saved }
+end
+
+-- sched.restore(state)
+-- Reemplaza todos los procesos por los de un sched.save() restaurado.
+-- Las entidades recuperan una corrutina nueva sin volver a llamar _init.
+function sched.restore(state)
+    sched.clear()
+    next_pid = math.max(next_pid, state.next_pid)
+
+    for _, saved in ipairs(state.tasks) do
+        local task = {
+            pid = saved.pid,
+            co = entity_coroutine(saved.entity, saved.pending_init),
+            entity = saved.entity,
+            active = true,
+            name = saved.name,
+            layer = saved.layer
+        }
+        -- Pasa por new_tasks para volver a indexarse en las regiones de activación
+        table.insert(sched.new_tasks, task)
+        sched.task_map[task.pid] = task
+    end
+end
 
                                                             return sched
@@ -1,3 +1,6 @@
+-- Bindings FFI para las llamadas calientes (si no hay FFI se quedan los clásicos)
+require("scripts.core.ffi_bindings").install()
+
 local Player = require("scripts.objects.player")
 
 local player_inst = nil
@@ -1,6 +1,7 @@
 local camera = {}
 local util = require("scripts.core.util")
 local config = require("scripts.config")
+local level_stream = require("scripts.core.level_stream")
 
 local Camera = {}
 Camera.__index = Camera
@@ -98,8 +99,14 @@ if not self.target then return end
 
                                             _G.camera_x = self.x
                                             _G.camera_y = self.y
+
+                                            -- Streaming de chunks del nivel alrededor de la nueva vista
+                                            level_stream.update(self.x, self.y)
                                             end
 
                                             -- Singleton
                                             camera.instance = Camera.new(nil)
+
+                                            -- La posición y el objetivo de la cámara viajan en los snapshots de rewind
+                                            require("scripts.core.rewind").track(camera.instance)
                                             return camera
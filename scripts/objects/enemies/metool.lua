@@ -8,6 +8,18 @@ local Metool = {}
 Metool.__index = Metool
 setmetatable(Metool, {__index = Enemy})
 
+-- Textura compartida por todas las instancias: una sola referencia del módulo
+-- (texture.load por instancia sumaría una referencia por spawn y nunca se desalojaría)
+local metool_tex = nil
+
+local function get_texture()
+    if not metool_tex then
+        local status, tex = pcall(function() return texture.load("assets/sprites/metool.png") end)
+        metool_tex = (status and tex > 0) and tex or false
+    end
+    return metool_tex
+end
+
 function Metool.new(args)
 local self = Enemy.new(args)
 setmetatable(self, Metool)
@@ -20,8 +32,8 @@ self.shoot_timer = 0
 self.shoot_interval = 120
 
 -- Intento de cargar textura, si falla, usa blanco
-local status, tex = pcall(function() return texture.load("assets/sprites/metool.png") end)
-self.has_texture = status and (tex > 0)
+local tex = get_texture()
+self.has_texture = tex ~= false
 if not self.has_texture then tex = texture.white() end
 
     self.anim = animator.new({
@@ -114,10 +126,10 @@ if not self.has_texture then tex = texture.white() end
                                                                 -- Fallback Visual si no hay PNG
                                                                 if self.state == "hide" then
                                                                     -- Dibujar cuadrado aplastado o de otro color para indicar escondido
-                                                                    batch.draw(texture.white(), draw_x, draw_y + 10, 0,0, self.body.w, self.body.h - 10, false)
+                                                                    batch.draw(texture.white(), draw_x, draw_y + 10, self.body.w, self.body.h - 10, 0, 0, 1, 1)
                                                                     else
                                                                         -- Dibujar normal
-                                                                        batch.draw(texture.white(), draw_x, draw_y, 0,0, self.body.w, self.body.h, false)
+                                                                        batch.draw(texture.white(), draw_x, draw_y, self.body.w, self.body.h, 0, 0, 1, 1)
                                                                         end
                                                                         end
                                                                         end
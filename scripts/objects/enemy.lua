@@ -105,7 +105,7 @@ if self.invincible_timer > 0 then return end
                                 local flip = (self.facing == 1)
                                 self.anim:draw(draw_x, draw_y, flip)
                                 else
-                                    batch.draw(self.tex_id, draw_x, draw_y, 0,0, self.body.w, self.body.h, false)
+                                    batch.draw(self.tex_id, draw_x, draw_y, self.body.w, self.body.h, 0, 0, 1, 1)
                                     end
                                     end
 
@@ -40,14 +40,11 @@ end
 
 -- Dibujado de Debug (Verde = Suelo)
 function level.draw()
-local tex = texture.white() -- Usamos la textura blanca del paso 1
+local tex = texture.white()
 
 for _, block in ipairs(_G.map_solids) do
-    -- Dibujar rectángulo verde oscuro
-    -- Hack: batch.draw no tiene color, pero los shaders suelen multiplicar.
-    -- Como nuestro shader básico usa color vertex attribute = 1,1,1,1 (blanco),
-    -- esto saldrá blanco. Para debug es suficiente.
-    batch.draw(tex, block.x, block.y, 0, 0, block.w, block.h, false)
+    -- Dibujar rectángulo verde oscuro (el color del vértice tiñe la textura blanca)
+    batch.draw(tex, block.x, block.y, block.w, block.h, 0, 0, 1, 1, 0.2, 0.5, 0.2, 1)
     end
     end
 
@@ -11,6 +11,9 @@ local particles = require("scripts.core.particles")
 local Player = {}
 Player.__index = Player
 
+-- Una referencia de textura por módulo, no por instancia (cada respawn crea un Player)
+local player_tex = nil
+
 function Player.new(args)
 local self = setmetatable({}, Player)
 args = args or {}
@@ -30,6 +33,7 @@ self.facing = 1
 self.invincible_timer = 0
 self.is_dead = false
 self.respawn_timer = 0
+self.always_active = true -- La cámara lo sigue: nunca se duerme
 
 self.is_dashing = false
 self.dash_timer = 0
@@ -44,7 +48,8 @@ self.charge_timer = 0
 self.is_charging = false
 self.charge_level = 0
 
-local tex_id = texture.load("assets/sprites/x.png")
+player_tex = player_tex or texture.load("assets/sprites/x.png")
+local tex_id = player_tex
 local anim_defs = {
     idle = { texture_id = tex_id, frames = {{x=0,y=0,w=32,h=32,dur=1}}, loop=true },
     run  = { texture_id = tex_id, frames = {{x=0,y=0,w=32,h=32,dur=1}}, loop=true },
@@ -309,9 +314,9 @@ for _, key in pairs(config.input.keys) do self.prev_keys[key] = input.down(key)
                                                                                                                                                                                                                                                                 local flip = (self.facing == -1)
 
                                                                                                                                                                                                                                                                 if self.charge_level == 1 then
-                                                                                                                                                                                                                                                                batch.draw(texture.white(), draw_x-2, draw_y-2, 0,0, self.body.w+4, self.body.h+4, false)
+                                                                                                                                                                                                                                                                batch.draw(texture.white(), draw_x-2, draw_y-2, self.body.w+4, self.body.h+4, 0, 0, 1, 1)
                                                                                                                                                                                                                                                                 elseif self.charge_level == 2 then
-                                                                                                                                                                                                                                                                batch.draw(texture.white(), draw_x-4, draw_y-4, 0,0, self.body.w+8, self.body.h+8, false)
+                                                                                                                                                                                                                                                                batch.draw(texture.white(), draw_x-4, draw_y-4, self.body.w+8, self.body.h+8, 0, 0, 1, 1)
                                                                                                                                                                                                                                                                 end
 
                                                                                                                                                                                                                                                                 self.anim:draw(draw_x, draw_y, flip)
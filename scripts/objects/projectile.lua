@@ -18,6 +18,7 @@ self.body.vy = args.vy or 0
 
 self.damage = args.damage or 1
 self.life_time = args.life_time or 60
+self.transient = true -- Fuera de la vista se destruye (dormido no agotaría su vida)
 
 local status, res = pcall(function() return texture.white() end)
 self.tex_id = args.tex_id or (status and res or 0)
@@ -26,30 +27,29 @@ return self
 end
 
 function Projectile:update()
--- 1. Movimiento
-self.body.x = self.body.x + self.body.vx
-self.body.y = self.body.y + self.body.vy
+-- Si soy disparo de jugador, busco enemigos
+local target_layer = (self.body.layer == physics.LAYER_PLAYER_SHOT)
+and physics.LAYER_ENEMY
+or physics.LAYER_PLAYER
+
+-- 1. Movimiento barrido: se detiene en el primer contacto del trayecto (mundo
+-- o entidad), así que a cualquier velocidad no atraviesa paredes finas ni enemigos
+local body = self.body
+local t, solid, hit_ent = physics.sweep(body, body.vx, body.vy, _G.map_solids or {}, target_layer)
+body.x = body.x + body.vx * t
+body.y = body.y + body.vy * t
 
 -- 2. Colisión con Mundo (Paredes)
-local map_solids = _G.map_solids or {}
-for _, solid in ipairs(map_solids) do
-    if self.body:check_collision(solid) then
-        self:on_wall_hit()
+if solid then
+    self:on_wall_hit()
+    return
+    end
+
+    -- 3. Colisión con Entidades (Daño)
+    if hit_ent then
+        self:on_hit_entity(hit_ent)
         return
         end
-        end
-
-        -- 3. Colisión con Entidades (Daño)
-        -- Si soy disparo de jugador, busco enemigos
-        local target_layer = (self.body.layer == physics.LAYER_PLAYER_SHOT)
-        and physics.LAYER_ENEMY
-        or physics.LAYER_PLAYER
-
-        local hit_ent = physics.check_entity_overlap(self.body, target_layer)
-        if hit_ent then
-            self:on_hit_entity(hit_ent)
-            return
-            end
 
             -- 4. Vida
             self.life_time = self.life_time - 1
@@ -77,7 +77,10 @@ for _, solid in ipairs(map_solids) do
                     local draw_x = self.body.x - cx
                     local draw_y = self.body.y - cy
 
-                    batch.draw(self.tex_id, draw_x, draw_y, 0, 0, self.body.w, self.body.h, self.body.vx < 0)
+                    -- Mirando a la izquierda: UVs invertidas en X
+                    local u0, u1 = 0, 1
+                    if self.body.vx < 0 then u0, u1 = 1, 0 end
+                    batch.draw(self.tex_id, draw_x, draw_y, self.body.w, self.body.h, u0, 0, u1, 1)
                     end
 
                     return Projectile
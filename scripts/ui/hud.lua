@@ -17,9 +17,9 @@ if not player then return end
         local y_pos = start_y + total_h - (i * 3)
 
         if i <= current_hp then
-            batch.draw(texture.white(), start_x, y_pos, 0, 0, 8, 2, false)
+            batch.draw(texture.white(), start_x, y_pos, 8, 2, 0, 0, 1, 1)
             else
-                batch.draw(texture.white(), start_x + 3, y_pos, 0, 0, 2, 2, false)
+                batch.draw(texture.white(), start_x + 3, y_pos, 2, 2, 0, 0, 1, 1)
                 end
                 end
                 end
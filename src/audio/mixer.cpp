@@ -0,0 +1,276 @@
+/**
+ * src/audio/mixer.cpp
+ * Ruta de audio de baja latencia sobre SDL_mixer (config.audio).
+ *
+ * - Buffer de dispositivo configurable; si el callback llega tarde repetidamente
+ *   (underrun) se duplica el buffer y se reabre el dispositivo (back-off).
+ * - Los SFX no pasan por Mix_PlayChannel (que empieza en el siguiente buffer, con
+ *   un jitter de hasta un buffer entero): cada disparo lleva el instante de su tick
+ *   de update y el callback de post-mix lo coloca en la muestra exacta que le
+ *   corresponde, con un retardo fijo. Disparos separados N ticks suenan separados
+ *   exactamente N * 1/60 s.
+ *
+ * SDL_mixer ya convierte los Mix_Chunk al formato del dispositivo al cargarlos
+ * (Mix_LoadWAV), así que el mezclado es una suma con saturación de S16.
+ */
+
+#include "../engine.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+static const int MAX_VOICES = 64;
+
+struct Voice {
+    Mix_Chunk* chunk = nullptr;
+    Uint32 pos = 0;              // Bytes ya mezclados
+    Sint64 start = 0;            // Frame de inicio dentro del próximo buffer
+    double time = 0.0;           // Instante del disparo (para medir la latencia)
+};
+
+struct Trigger {
+    Mix_Chunk* chunk;
+    double time;                 // Instante del tick que lo disparó
+};
+
+struct MixerState {
+    AudioConfig config;
+    bool open = false;
+    bool scheduled = false;      // Mezcla propia activa (low_latency + formato S16)
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    int buffer = 0;              // Frames por callback (el pedido a Mix_OpenAudio)
+    double period = 0.0;         // Duración de un buffer (s)
+    double delay = 0.0;          // Retardo fijo disparo -> muestra
+
+    double tick_time = 0.0;      // Instante del tick de update en curso
+    int sfx_volume = MIX_MAX_VOLUME;
+
+    // Compartido con el hilo de audio (protegido por mutex)
+    std::mutex mutex;
+    std::vector<Trigger> pending;
+    Voice voices[MAX_VOICES];
+    int voice_count = 0;
+    double last_callback = 0.0;
+    AudioStats stats;
+
+    Uint64 underruns_checked = 0; // Underruns ya vistos por audio_update()
+    Uint32 window_start = 0;
+};
+
+static MixerState mx;
+
+static double audio_now() {
+    return (double)SDL_GetPerformanceCounter() / (double)SDL_GetPerformanceFrequency();
+}
+
+// Callback de post-mix (hilo de audio): SDL_mixer ya dejó música y canales en 'stream'
+static void mix_voices(void*, Uint8* stream, int len) {
+    double now = audio_now();
+    std::lock_guard<std::mutex> lock(mx.mutex);
+
+    // Un callback que llega más de medio buffer tarde = el dispositivo se quedó sin datos
+    if (mx.last_callback > 0.0 && now - mx.last_callback > mx.period * 1.5 + 0.002) {
+        mx.stats.underruns++;
+    }
+    mx.last_callback = now;
+
+    const int frame_bytes = mx.channels * (int)sizeof(Sint16);
+    const Sint64 frames = len / frame_bytes;
+
+    // Disparos nuevos: su muestra = instante del tick + retardo fijo
+    for (const Trigger& t : mx.pending) {
+        if (mx.voice_count == MAX_VOICES) {
+            // Sin voces libres: se pierde la más antigua
+            for (int i = 1; i < mx.voice_count; ++i) mx.voices[i - 1] = mx.voices[i];
+            mx.voice_count--;
+            mx.stats.voices_stolen++;
+        }
+        Sint64 start = (Sint64)std::llround((t.time + mx.delay - now) * mx.frequency);
+        if (start < 0) {
+            start = 0;
+            mx.stats.late_triggers++;
+        }
+        mx.voices[mx.voice_count++] = Voice{t.chunk, 0, start, t.time};
+    }
+    mx.pending.clear();
+
+    Sint16* out = (Sint16*)stream;
+    int volume = mx.sfx_volume;
+    int alive = 0;
+    for (int v = 0; v < mx.voice_count; ++v) {
+        Voice voice = mx.voices[v];
+
+        if (voice.start >= frames) {
+            voice.start -= frames;
+            mx.voices[alive++] = voice;
+            continue;
+        }
+        if (voice.pos == 0) {
+            // Latencia audible: este buffer sale cuando termina el que está sonando
+            double latency = now + mx.period + (double)voice.start / mx.frequency - voice.time;
+            double ms = latency * 1000.0;
+            mx.stats.latency_ms = mx.stats.latency_ms == 0.0 ? ms : mx.stats.latency_ms * 0.9 + ms * 0.1;
+            mx.stats.max_latency_ms = std::max(mx.stats.max_latency_ms, ms);
+        }
+
+        const Sint16* src = (const Sint16*)(voice.chunk->abuf + voice.pos);
+        Sint64 available = (Sint64)(voice.chunk->alen - voice.pos) / frame_bytes;
+        Sint64 count = std::min(frames - voice.start, available);
+        Sint16* dst = out + voice.start * mx.channels;
+        for (Sint64 i = 0; i < count * mx.channels; ++i) {
+            int sample = dst[i] + src[i] * volume / MIX_MAX_VOLUME;
+            dst[i] = (Sint16)std::max(-32768, std::min(32767, sample));
+        }
+
+        voice.pos += (Uint32)(count * frame_bytes);
+        voice.start = 0;
+        if (voice.pos + frame_bytes <= voice.chunk->alen) mx.voices[alive++] = voice;
+    }
+    mx.voice_count = alive;
+}
+
+static bool open_device() {
+    if (Mix_OpenAudio(mx.config.frequency, MIX_DEFAULT_FORMAT, 2, mx.buffer) < 0) {
+        std::cerr << "[AUDIO] Mixer Error: " << Mix_GetError() << std::endl;
+        return false;
+    }
+    Mix_AllocateChannels(mx.config.channels);
+    Mix_Volume(-1, mx.sfx_volume);
+    Mix_QuerySpec(&mx.frequency, &mx.format, &mx.channels);
+
+    mx.period = (double)mx.buffer / (double)mx.frequency;
+    // Un buffer de margen + un tick: los ticks de un frame se simulan en ráfaga
+    mx.delay = mx.period + engine.MS_PER_UPDATE;
+    mx.last_callback = 0.0;
+
+    mx.scheduled = mx.config.low_latency && mx.format == AUDIO_S16SYS;
+    if (mx.config.low_latency && !mx.scheduled) {
+        std::cerr << "[AUDIO] Formato del dispositivo no es S16: SFX sin planificar" << std::endl;
+    }
+    Mix_SetPostMix(mx.scheduled ? mix_voices : nullptr, nullptr);
+    mx.open = true;
+
+    std::cout << "[AUDIO] " << mx.frequency << " Hz, buffer " << mx.buffer
+              << " (" << mx.period * 1000.0 << " ms)" << (mx.scheduled ? ", SFX planificados" : "") << std::endl;
+    return true;
+}
+
+bool audio_open(const AudioConfig& config) {
+    mx.config = config;
+    mx.buffer = config.low_latency ? config.buffer : std::max(config.buffer, 2048);
+    mx.window_start = SDL_GetTicks();
+    return open_device();
+}
+
+void audio_close() {
+    if (!mx.open) return;
+    Mix_SetPostMix(nullptr, nullptr);
+    Mix_CloseAudio();
+    mx.open = false;
+
+    std::lock_guard<std::mutex> lock(mx.mutex);
+    mx.voice_count = 0;
+    mx.pending.clear();
+}
+
+// Back-off: dispositivo reabierto con el doble de buffer. Mismo formato pedido,
+// así que los chunks cargados siguen siendo válidos; la música vuelve a empezar.
+static void back_off() {
+    int frequency = mx.frequency;
+    Uint16 format = mx.format;
+    int channels = mx.channels;
+
+    audio_close();
+    mx.buffer *= 2;
+    mx.stats.backoffs++;
+    std::cerr << "[AUDIO] Underruns repetidos: buffer -> " << mx.buffer << std::endl;
+    if (!open_device()) return;
+
+    if (mx.frequency != frequency || mx.format != format || mx.channels != channels) {
+        // El dispositivo cambió de formato: los SFX se recargan al volver a pedirlos
+        audio_free_sfx();
+    }
+    if (engine.current_music) Mix_PlayMusic(engine.current_music, engine.current_music_loop ? -1 : 1);
+}
+
+// Una vez por frame (hilo principal)
+void audio_update() {
+    if (!mx.open || !mx.config.low_latency) return;
+
+    Uint32 now = SDL_GetTicks();
+    if (now - mx.window_start < 1000) return;
+    mx.window_start = now;
+
+    Uint64 underruns;
+    {
+        std::lock_guard<std::mutex> lock(mx.mutex);
+        underruns = mx.stats.underruns;
+    }
+    Uint64 recent = underruns - mx.underruns_checked;
+    mx.underruns_checked = underruns;
+
+    if ((int)recent >= mx.config.underrun_limit && mx.buffer < mx.config.max_buffer) back_off();
+}
+
+void audio_set_tick_time(double time) {
+    mx.tick_time = time;
+}
+
+// Dispara un SFX en el tick actual. Sin mezcla propia, Mix_PlayChannel como siempre.
+void audio_play(Mix_Chunk* chunk) {
+    if (!mx.open || !chunk) return;
+
+    if (!mx.scheduled) {
+        Mix_PlayChannel(-1, chunk, 0);
+        return;
+    }
+    // Fuera de _update (p.ej. _init) el disparo va "ahora"
+    double time = mx.tick_time > 0.0 ? mx.tick_time : audio_now();
+    std::lock_guard<std::mutex> lock(mx.mutex);
+    mx.pending.push_back(Trigger{chunk, time});
+    mx.stats.triggers++;
+}
+
+bool audio_chunk_in_use(Mix_Chunk* chunk) {
+    std::lock_guard<std::mutex> lock(mx.mutex);
+    for (const Trigger& t : mx.pending) {
+        if (t.chunk == chunk) return true;
+    }
+    for (int i = 0; i < mx.voice_count; ++i) {
+        if (mx.voices[i].chunk == chunk) return true;
+    }
+    return false;
+}
+
+void audio_set_sfx_volume(int volume) {
+    Mix_Volume(-1, volume);
+    std::lock_guard<std::mutex> lock(mx.mutex);
+    mx.sfx_volume = volume;
+}
+
+AudioStats audio_stats() {
+    AudioStats s;
+    {
+        std::lock_guard<std::mutex> lock(mx.mutex);
+        s = mx.stats;
+        s.voices = mx.voice_count;
+    }
+    s.open = mx.open;
+    s.scheduled = mx.scheduled;
+    s.frequency = mx.frequency;
+    s.buffer = mx.buffer;
+    s.buffer_ms = mx.period * 1000.0;
+    return s;
+}
+
+std::string audio_report_line() {
+    AudioStats s = audio_stats();
+    char line[192];
+    snprintf(line, sizeof(line),
+             "audio buffer=%d (%.1fms) latency=%.1fms max=%.1fms underruns=%llu backoffs=%u voices=%d",
+             s.buffer, s.buffer_ms, s.latency_ms, s.max_latency_ms,
+             (unsigned long long)s.underruns, s.backoffs, s.voices);
+    return line;
+}
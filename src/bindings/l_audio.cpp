@@ -1,6 +1,37 @@
 #include "../engine.hpp"
 #include <SDL2/SDL_mixer.h>
 
+// ¿Está sonando el chunk en algún canal (o voz planificada)?
+static bool chunk_playing(Mix_Chunk* chunk) {
+    if (audio_chunk_in_use(chunk)) return true;
+    int channels = Mix_AllocateChannels(-1);
+    for (int i = 0; i < channels; ++i) {
+        if (Mix_Playing(i) && Mix_GetChunk(i) == chunk) return true;
+    }
+    return false;
+}
+
+// Desalojador LRU de SFX: libera los que no están sonando, el más antiguo primero
+static size_t evict_sfx(size_t bytes) {
+    size_t freed = 0;
+    while (freed < bytes) {
+        auto victim = engine.sfx_cache.end();
+        for (auto it = engine.sfx_cache.begin(); it != engine.sfx_cache.end(); ++it) {
+            if (chunk_playing(it->second.chunk)) continue;
+            if (victim == engine.sfx_cache.end() || it->second.last_used < victim->second.last_used) {
+                victim = it;
+            }
+        }
+        if (victim == engine.sfx_cache.end()) break;
+
+        freed += victim->second.chunk->alen;
+        mem_track(MEM_SFX, -(long long)victim->second.chunk->alen);
+        Mix_FreeChunk(victim->second.chunk);
+        engine.sfx_cache.erase(victim);
+    }
+    return freed;
+}
+
 // Función auxiliar local para reutilizar lógica de caché
 static Mix_Chunk* get_chunk(const char* path) {
     std::string s_path = path;
@@ -8,32 +39,61 @@ static Mix_Chunk* get_chunk(const char* path) {
 
     // Si está en caché, devolverlo
     if (it != engine.sfx_cache.end()) {
-        return it->second;
+        it->second.last_used = SDL_GetTicks();
+        return it->second.chunk;
     }
 
     // Si no, cargar, cachear y devolver
     Mix_Chunk* chunk = Mix_LoadWAV(path);
     if (chunk) {
-        engine.sfx_cache[s_path] = chunk;
+        engine.sfx_cache[s_path] = CachedSfx{chunk, SDL_GetTicks()};
+        mem_track(MEM_SFX, (long long)chunk->alen);
+        mem_set_evictor(MEM_SFX, evict_sfx);
     } else {
         std::cerr << "[LUA AUDIO] Error cargando SFX: " << path << " -> " << Mix_GetError() << std::endl;
     }
     return chunk;
 }
 
+// Libera toda la caché de SFX (cierre del motor o cambio de formato del dispositivo)
+void audio_free_sfx() {
+    for (auto const& [path, sfx] : engine.sfx_cache) {
+        mem_track(MEM_SFX, -(long long)sfx.chunk->alen);
+        Mix_FreeChunk(sfx.chunk);
+    }
+    engine.sfx_cache.clear();
+}
+
 // Lua: audio.play_sfx(path)
+// Suena en la muestra que corresponde al tick de update actual (modo low_latency)
 static int l_play_sfx(lua_State* L) {
     const char* path = luaL_checkstring(L, 1);
 
     Mix_Chunk* chunk = get_chunk(path);
-    if (chunk) {
-        // Canal -1 (automático), loop 0 (reproducir 1 vez)
-        Mix_PlayChannel(-1, chunk, 0);
-    }
+    if (chunk) audio_play(chunk);
 
     return 0;
 }
 
+// Lua: audio.preload(path | {paths}) -> cargados
+// Carga (y convierte al formato del dispositivo) antes del primer disparo
+static int l_preload(lua_State* L) {
+    int loaded = 0;
+    if (lua_istable(L, 1)) {
+        int n = (int)lua_objlen(L, 1);
+        for (int i = 1; i <= n; ++i) {
+            lua_rawgeti(L, 1, i);
+            const char* path = lua_tostring(L, -1);
+            if (path && get_chunk(path)) loaded++;
+            lua_pop(L, 1);
+        }
+    } else if (get_chunk(luaL_checkstring(L, 1))) {
+        loaded++;
+    }
+    lua_pushinteger(L, loaded);
+    return 1;
+}
+
 // Lua: audio.play_music(path, loop)
 static int l_play_music(lua_State* L) {
     const char* path = luaL_checkstring(L, 1);
@@ -44,11 +104,23 @@ static int l_play_music(lua_State* L) {
         Mix_HaltMusic();
         Mix_FreeMusic(engine.current_music);
         engine.current_music = nullptr;
+        mem_track(MEM_MUSIC, -(long long)engine.current_music_bytes);
+        engine.current_music_bytes = 0;
     }
 
     engine.current_music = Mix_LoadMUS(path);
     if (engine.current_music) {
+        // SDL_mixer decodifica en streaming: contamos el tamaño del archivo
+        SDL_RWops* file = SDL_RWFromFile(path, "rb");
+        if (file) {
+            Sint64 size = SDL_RWsize(file);
+            engine.current_music_bytes = size > 0 ? (size_t)size : 0;
+            SDL_RWclose(file);
+        }
+        mem_track(MEM_MUSIC, (long long)engine.current_music_bytes);
+
         // SDL_mixer: -1 para loop infinito, 1 para reproducir una vez
+        engine.current_music_loop = loop;
         Mix_PlayMusic(engine.current_music, loop ? -1 : 1);
     } else {
         std::cerr << "[LUA AUDIO] Error cargando Musica: " << path << " -> " << Mix_GetError() << std::endl;
@@ -64,14 +136,51 @@ static int l_set_volume(lua_State* L) {
     if (vol < 0) vol = 0;
     if (vol > MIX_MAX_VOLUME) vol = MIX_MAX_VOLUME;
 
-    Mix_Volume(-1, vol);       // Volumen global de SFX
+    audio_set_sfx_volume(vol); // Volumen global de SFX (canales y voces planificadas)
     Mix_VolumeMusic(vol);      // Volumen de Música
     return 0;
 }
 
+// Lua: audio.stats() -> tabla
+// { open, scheduled, frequency, buffer, buffer_ms, latency_ms, max_latency_ms,
+//   underruns, backoffs, triggers, late_triggers, voices_stolen, voices }
+static int l_audio_stats(lua_State* L) {
+    AudioStats s = audio_stats();
+    lua_createtable(L, 0, 13);
+    lua_pushboolean(L, s.open);
+    lua_setfield(L, -2, "open");
+    lua_pushboolean(L, s.scheduled);
+    lua_setfield(L, -2, "scheduled");
+    lua_pushinteger(L, s.frequency);
+    lua_setfield(L, -2, "frequency");
+    lua_pushinteger(L, s.buffer);
+    lua_setfield(L, -2, "buffer");
+    lua_pushnumber(L, s.buffer_ms);
+    lua_setfield(L, -2, "buffer_ms");
+    lua_pushnumber(L, s.latency_ms);
+    lua_setfield(L, -2, "latency_ms");
+    lua_pushnumber(L, s.max_latency_ms);
+    lua_setfield(L, -2, "max_latency_ms");
+    lua_pushnumber(L, (lua_Number)s.underruns);
+    lua_setfield(L, -2, "underruns");
+    lua_pushinteger(L, s.backoffs);
+    lua_setfield(L, -2, "backoffs");
+    lua_pushnumber(L, (lua_Number)s.triggers);
+    lua_setfield(L, -2, "triggers");
+    lua_pushnumber(L, (lua_Number)s.late_triggers);
+    lua_setfield(L, -2, "late_triggers");
+    lua_pushnumber(L, (lua_Number)s.voices_stolen);
+    lua_setfield(L, -2, "voices_stolen");
+    lua_pushinteger(L, s.voices);
+    lua_setfield(L, -2, "voices");
+    return 1;
+}
+
 // Registro de funciones
 static const struct luaL_Reg audio_lib[] = {
     {"play_sfx", l_play_sfx},
+    {"preload", l_preload},
+    {"stats", l_audio_stats},
     {"play_music", l_play_music},
     {"set_volume", l_set_volume},
     {NULL, NULL}
@@ -0,0 +1,125 @@
+/**
+ * src/bindings/l_collide.cpp
+ * Módulo 'collide': barridos de AABB (colisión continua).
+ * scripts/core/physics.lua lo envuelve (physics.sweep, move_and_slide).
+ */
+
+#include "../engine.hpp"
+
+// Lee x, y, w, h de un cuerpo Lua en el índice idx
+static CollideRect read_rect(lua_State* L, int idx) {
+    CollideRect r;
+    lua_getfield(L, idx, "x");
+    lua_getfield(L, idx, "y");
+    lua_getfield(L, idx, "w");
+    lua_getfield(L, idx, "h");
+    r.x = (float)lua_tonumber(L, -4);
+    r.y = (float)lua_tonumber(L, -3);
+    r.w = (float)lua_tonumber(L, -2);
+    r.h = (float)lua_tonumber(L, -1);
+    lua_pop(L, 4);
+    return r;
+}
+
+static CollideRect check_box(lua_State* L, int first) {
+    CollideRect box;
+    box.x = (float)luaL_checknumber(L, first);
+    box.y = (float)luaL_checknumber(L, first + 1);
+    box.w = (float)luaL_checknumber(L, first + 2);
+    box.h = (float)luaL_checknumber(L, first + 3);
+    return box;
+}
+
+// t, nx, ny, index (nil si no hay contacto; índice 1-based en la lista)
+static int push_hit(lua_State* L, const SweepHit& hit) {
+    lua_pushnumber(L, hit.t);
+    lua_pushnumber(L, hit.nx);
+    lua_pushnumber(L, hit.ny);
+    if (hit.index >= 0) lua_pushinteger(L, hit.index + 1);
+    else lua_pushnil(L);
+    return 4;
+}
+
+// Lua: collide.set_solids(bodies) -> count
+// Copia los AABB de la lista (tablas con x, y, w, h) al conjunto estático
+static int l_collide_set_solids(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int n = (int)lua_objlen(L, 1);
+
+    std::vector<CollideRect> solids;
+    solids.reserve(n);
+    for (int i = 1; i <= n; ++i) {
+        lua_rawgeti(L, 1, i);
+        solids.push_back(read_rect(L, -1));
+        lua_pop(L, 1);
+    }
+    collide_set_solids(std::move(solids));
+    lua_pushinteger(L, n);
+    return 1;
+}
+
+// Lua: collide.sweep(x, y, w, h, dx, dy, [hit_overlap]) -> t, nx, ny, index
+// Primer sólido estático que toca la caja al desplazarse (dx, dy)
+static int l_collide_sweep(lua_State* L) {
+    CollideRect box = check_box(L, 1);
+    float dx = (float)luaL_checknumber(L, 5);
+    float dy = (float)luaL_checknumber(L, 6);
+    bool hit_overlap = lua_toboolean(L, 7);
+
+    SweepHit hit;
+    collide_sweep(box, dx, dy, hit_overlap, &hit);
+    return push_hit(L, hit);
+}
+
+// Lua: collide.sweep_bodies(x, y, w, h, dx, dy, bodies, [hit_overlap]) -> t, nx, ny, index
+// Igual contra una lista de cuerpos dinámicos (en su posición actual)
+static int l_collide_sweep_bodies(lua_State* L) {
+    CollideRect box = check_box(L, 1);
+    float dx = (float)luaL_checknumber(L, 5);
+    float dy = (float)luaL_checknumber(L, 6);
+    luaL_checktype(L, 7, LUA_TTABLE);
+    bool hit_overlap = lua_toboolean(L, 8);
+
+    SweepHit best;
+    int n = (int)lua_objlen(L, 7);
+    for (int i = 1; i <= n; ++i) {
+        lua_rawgeti(L, 7, i);
+        CollideRect other = read_rect(L, -1);
+        lua_pop(L, 1);
+
+        SweepHit hit;
+        if (sweep_aabb(box, dx, dy, other, hit_overlap, &hit) && (best.index < 0 || hit.t < best.t)) {
+            hit.index = i - 1;
+            best = hit;
+        }
+    }
+    return push_hit(L, best);
+}
+
+// Lua: collide.stats() -> { sweeps, candidates, resyncs, solids }
+static int l_collide_stats(lua_State* L) {
+    const CollideStats& s = collide_stats();
+    lua_createtable(L, 0, 4);
+    lua_pushnumber(L, (lua_Number)s.sweeps);
+    lua_setfield(L, -2, "sweeps");
+    lua_pushnumber(L, (lua_Number)s.candidates);
+    lua_setfield(L, -2, "candidates");
+    lua_pushnumber(L, (lua_Number)s.resyncs);
+    lua_setfield(L, -2, "resyncs");
+    lua_pushinteger(L, (lua_Integer)s.solids);
+    lua_setfield(L, -2, "solids");
+    return 1;
+}
+
+static const struct luaL_Reg collide_lib[] = {
+    {"set_solids", l_collide_set_solids},
+    {"sweep", l_collide_sweep},
+    {"sweep_bodies", l_collide_sweep_bodies},
+    {"stats", l_collide_stats},
+    {NULL, NULL}
+};
+
+int luaopen_collide(lua_State* L) {
+    luaL_register(L, "collide", collide_lib);
+    return 1;
+}
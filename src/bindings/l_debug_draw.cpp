@@ -0,0 +1,93 @@
+/**
+ * src/bindings/l_debug_draw.cpp
+ * Módulo 'debugdraw': primitivas de depuración sin textura (hitboxes, contactos).
+ * Deshabilitado, cada llamada vuelve antes de leer sus argumentos.
+ */
+
+#include "../engine.hpp"
+
+// Color opcional a partir del argumento 'idx' (r, g, b, [a]); default blanco opaco
+static void check_color(lua_State* L, int idx, float* r, float* g, float* b, float* a) {
+    *r = (float)luaL_optnumber(L, idx, 1.0);
+    *g = (float)luaL_optnumber(L, idx + 1, 1.0);
+    *b = (float)luaL_optnumber(L, idx + 2, 1.0);
+    *a = (float)luaL_optnumber(L, idx + 3, 1.0);
+}
+
+// Lua: debugdraw.rect(x, y, w, h, [r, g, b, a])
+static int l_debugdraw_rect(lua_State* L) {
+    if (!debug_draw_enabled()) return 0;
+    float r, g, b, a;
+    check_color(L, 5, &r, &g, &b, &a);
+    debug_draw_rect(luaL_checknumber(L, 1), luaL_checknumber(L, 2),
+                    luaL_checknumber(L, 3), luaL_checknumber(L, 4), r, g, b, a);
+    return 0;
+}
+
+// Lua: debugdraw.outline(x, y, w, h, [r, g, b, a])
+static int l_debugdraw_outline(lua_State* L) {
+    if (!debug_draw_enabled()) return 0;
+    float r, g, b, a;
+    check_color(L, 5, &r, &g, &b, &a);
+    debug_draw_outline(luaL_checknumber(L, 1), luaL_checknumber(L, 2),
+                       luaL_checknumber(L, 3), luaL_checknumber(L, 4), r, g, b, a);
+    return 0;
+}
+
+// Lua: debugdraw.line(x0, y0, x1, y1, [r, g, b, a])
+static int l_debugdraw_line(lua_State* L) {
+    if (!debug_draw_enabled()) return 0;
+    float r, g, b, a;
+    check_color(L, 5, &r, &g, &b, &a);
+    debug_draw_line(luaL_checknumber(L, 1), luaL_checknumber(L, 2),
+                    luaL_checknumber(L, 3), luaL_checknumber(L, 4), r, g, b, a);
+    return 0;
+}
+
+// Lua: debugdraw.cross(x, y, size, [r, g, b, a])
+static int l_debugdraw_cross(lua_State* L) {
+    if (!debug_draw_enabled()) return 0;
+    float r, g, b, a;
+    check_color(L, 4, &r, &g, &b, &a);
+    debug_draw_cross(luaL_checknumber(L, 1), luaL_checknumber(L, 2),
+                     luaL_checknumber(L, 3), r, g, b, a);
+    return 0;
+}
+
+// Lua: debugdraw.enabled() -> bool
+// Los scripts lo consultan una vez por frame para saltarse el recorrido entero
+static int l_debugdraw_enabled(lua_State* L) {
+    lua_pushboolean(L, debug_draw_enabled());
+    return 1;
+}
+
+// Lua: debugdraw.set_enabled(bool)
+// Sin efecto si el motor se compiló con DEBUG_DRAW=0
+static int l_debugdraw_set_enabled(lua_State* L) {
+    debug_draw_set_enabled(lua_toboolean(L, 1) != 0);
+    return 0;
+}
+
+// Lua: debugdraw.stats() -> primitives, vertices (último frame)
+static int l_debugdraw_stats(lua_State* L) {
+    const DebugDrawStats& s = debug_draw_stats();
+    lua_pushinteger(L, s.primitives);
+    lua_pushinteger(L, s.vertices);
+    return 2;
+}
+
+static const luaL_Reg debugdraw_lib[] = {
+    {"rect", l_debugdraw_rect},
+    {"outline", l_debugdraw_outline},
+    {"line", l_debugdraw_line},
+    {"cross", l_debugdraw_cross},
+    {"enabled", l_debugdraw_enabled},
+    {"set_enabled", l_debugdraw_set_enabled},
+    {"stats", l_debugdraw_stats},
+    {NULL, NULL}
+};
+
+int luaopen_debugdraw(lua_State* L) {
+    luaL_register(L, "debugdraw", debugdraw_lib);
+    return 1;
+}
@@ -1,7 +1,22 @@
 #include "../engine.hpp"
 
-// Lua: batch.draw(tex_id, x, y, w, h, u0, v0, u1, v1)
-// Simplificado: opcionalmente color r,g,b,a
+// ABI C (FFI): mismas operaciones que batch.draw/flush/set_camera sin pasar por la pila Lua
+extern "C" void xpp_batch_draw(Uint32 tex, float x, float y, float w, float h,
+                               float u0, float v0, float u1, float v1,
+                               float r, float g, float b, float a, int palette) {
+    draw_sprite(tex, x, y, w, h, u0, v0, u1, v1, r, g, b, a, palette);
+}
+
+extern "C" void xpp_batch_flush(void) {
+    flush_batch();
+}
+
+extern "C" void xpp_batch_set_camera(float x, float y) {
+    set_camera(x, y);
+}
+
+// Lua: batch.draw(tex_id, x, y, w, h, u0, v0, u1, v1, [r, g, b, a, [palette]])
+// Simplificado: opcionalmente color r,g,b,a y paleta (texturas indexadas)
 static int l_batch_draw(lua_State* L) {
     // Argumentos obligatorios
     GLuint tex = (GLuint)luaL_checkinteger(L, 1);
@@ -22,8 +37,9 @@ static int l_batch_draw(lua_State* L) {
         b = luaL_checknumber(L, 12);
         a = luaL_checknumber(L, 13);
     }
+    int palette = (int)luaL_optinteger(L, 14, -1);
 
-    draw_sprite(tex, x, y, w, h, u0, v0, u1, v1, r, g, b, a);
+    draw_sprite(tex, x, y, w, h, u0, v0, u1, v1, r, g, b, a, palette);
     return 0;
 }
 
@@ -41,7 +57,67 @@ static int l_batch_flush(lua_State* L) {
     return 0;
 }
 
+// Lua: batch.gl_stats() -> issued, skipped
+// Llamadas GL emitidas y evitadas por la caché de estado desde el arranque
+static int l_batch_gl_stats(lua_State* L) {
+    const GLStateStats& stats = gl_state_stats();
+    lua_pushnumber(L, (lua_Number)stats.issued);
+    lua_pushnumber(L, (lua_Number)stats.skipped);
+    return 2;
+}
+
+// Lua: graphics.stats() -> tabla del último frame
+// { draw_calls, vertices, flushes, texture_binds, bytes_uploaded,
+//   flush_reasons = { explicit, texture, full, camera },
+//   gpu_ms = { scene, debug }, gpu_valid = { scene, debug }, gpu_dropped }
+// gpu_ms llega con unos frames de retraso (queries leídas sin bloquear); si
+// gpu_valid[pasada] es false no hubo medida en ese frame y gpu_ms vale 0
+static int l_graphics_stats(lua_State* L) {
+    static const char* reason_names[FLUSH_REASON_COUNT] = { "explicit", "texture", "full", "camera" };
+    const RenderFrameStats& s = render_stats();
+
+    lua_createtable(L, 0, 9);
+    lua_pushinteger(L, s.draw_calls);
+    lua_setfield(L, -2, "draw_calls");
+    lua_pushinteger(L, s.vertices);
+    lua_setfield(L, -2, "vertices");
+    lua_pushinteger(L, s.flushes);
+    lua_setfield(L, -2, "flushes");
+    lua_pushinteger(L, s.texture_binds);
+    lua_setfield(L, -2, "texture_binds");
+    lua_pushnumber(L, (lua_Number)s.bytes_uploaded);
+    lua_setfield(L, -2, "bytes_uploaded");
+
+    lua_createtable(L, 0, FLUSH_REASON_COUNT);
+    for (int i = 0; i < FLUSH_REASON_COUNT; ++i) {
+        lua_pushinteger(L, s.flush_reasons[i]);
+        lua_setfield(L, -2, reason_names[i]);
+    }
+    lua_setfield(L, -2, "flush_reasons");
+
+    lua_createtable(L, 0, RENDER_PASS_COUNT);
+    for (int i = 0; i < RENDER_PASS_COUNT; ++i) {
+        lua_pushnumber(L, s.gpu_ms[i]);
+        lua_setfield(L, -2, render_pass_name((RenderPass)i));
+    }
+    lua_setfield(L, -2, "gpu_ms");
+
+    lua_createtable(L, 0, RENDER_PASS_COUNT);
+    for (int i = 0; i < RENDER_PASS_COUNT; ++i) {
+        lua_pushboolean(L, s.gpu_valid[i]);
+        lua_setfield(L, -2, render_pass_name((RenderPass)i));
+    }
+    lua_setfield(L, -2, "gpu_valid");
+
+    lua_pushnumber(L, (lua_Number)s.gpu_dropped);
+    lua_setfield(L, -2, "gpu_dropped");
+    return 1;
+}
+
 // Lua: texture.load(path) -> id, width, height
+// Cada llamada suma una referencia (también en acierto de caché) que el llamante
+// debe soltar con texture.release; las texturas con referencias nunca se desalojan.
+// Los sprites se cargan una vez por módulo, no en cada new().
 static int l_texture_load(lua_State* L) {
     const char* path = luaL_checkstring(L, 1);
     int w, h;
@@ -59,16 +135,122 @@ static int l_texture_load(lua_State* L) {
     return 3;
 }
 
+// Lua: texture.load_indexed(path) -> id, width, height, palette
+// Misma regla de referencias que texture.load
+// PNG de 8 bits con paleta: textura R8 (1 byte/píxel) + su paleta en el atlas
+static int l_texture_load_indexed(lua_State* L) {
+    const char* path = luaL_checkstring(L, 1);
+    int w, h, palette;
+    GLuint id = load_texture_indexed(path, &w, &h, &palette);
+
+    if (id == 0) {
+        lua_pushnil(L);
+        lua_pushstring(L, "Error loading indexed texture");
+        return 2;
+    }
+
+    lua_pushinteger(L, id);
+    lua_pushinteger(L, w);
+    lua_pushinteger(L, h);
+    lua_pushinteger(L, palette);
+    return 4;
+}
+
+// Lua: texture.white() -> id
+// Textura blanca 1x1: batch.draw(texture.white(), x, y, w, h, 0, 0, 1, 1, r, g, b, a)
+static int l_texture_white(lua_State* L) {
+    lua_pushinteger(L, white_texture());
+    return 1;
+}
+
+// Lua: texture.release(id)
+// Suelta una referencia; sin referencias la textura puede desalojarse por presupuesto
+static int l_texture_release(lua_State* L) {
+    release_texture((GLuint)luaL_checkinteger(L, 1));
+    return 0;
+}
+
+// Lua: palette.create([from]) -> id | nil
+// Nueva paleta, copia de 'from' si se indica (p.ej. la de texture.load_indexed)
+static int l_palette_create(lua_State* L) {
+    int row = palette_create((int)luaL_optinteger(L, 1, -1));
+    if (row < 0) {
+        lua_pushnil(L);
+        lua_pushstring(L, "Palette atlas full");
+        return 2;
+    }
+    lua_pushinteger(L, row);
+    return 1;
+}
+
+// Lua: palette.set(id, index, r, g, b, [a])
+// Colores 0..1 como batch.draw; se ve en el siguiente flush del batch
+static int l_palette_set(lua_State* L) {
+    int row = (int)luaL_checkinteger(L, 1);
+    int index = (int)luaL_checkinteger(L, 2);
+    float r = luaL_checknumber(L, 3);
+    float g = luaL_checknumber(L, 4);
+    float b = luaL_checknumber(L, 5);
+    float a = luaL_optnumber(L, 6, 1.0);
+    if (!palette_set(row, index, r, g, b, a)) {
+        return luaL_error(L, "palette.set: invalid palette %d or index %d", row, index);
+    }
+    return 0;
+}
+
+// Lua: palette.get(id, index) -> r, g, b, a
+static int l_palette_get(lua_State* L) {
+    float rgba[4];
+    if (!palette_get((int)luaL_checkinteger(L, 1), (int)luaL_checkinteger(L, 2), rgba)) {
+        lua_pushnil(L);
+        return 1;
+    }
+    for (int i = 0; i < 4; ++i) lua_pushnumber(L, rgba[i]);
+    return 4;
+}
+
+// Lua: palette.release(id)
+// Solo para paletas de palette.create; las de las texturas se van con ellas
+static int l_palette_release(lua_State* L) {
+    palette_release((int)luaL_checkinteger(L, 1));
+    return 0;
+}
+
+// Lua: palette.stats() -> used, capacity
+static int l_palette_stats(lua_State* L) {
+    lua_pushinteger(L, palette_count());
+    lua_pushinteger(L, PALETTE_ROWS);
+    return 2;
+}
+
 // Registro de librerías
 static const struct luaL_Reg batch_lib[] = {
     {"draw", l_batch_draw},
     {"flush", l_batch_flush},
     {"set_camera", l_batch_set_camera},
+    {"gl_stats", l_batch_gl_stats},
+    {NULL, NULL}
+};
+
+static const struct luaL_Reg graphics_lib[] = {
+    {"stats", l_graphics_stats},
     {NULL, NULL}
 };
 
 static const struct luaL_Reg texture_lib[] = {
     {"load", l_texture_load},
+    {"load_indexed", l_texture_load_indexed},
+    {"release", l_texture_release},
+    {"white", l_texture_white},
+    {NULL, NULL}
+};
+
+static const struct luaL_Reg palette_lib[] = {
+    {"create", l_palette_create},
+    {"set", l_palette_set},
+    {"get", l_palette_get},
+    {"release", l_palette_release},
+    {"stats", l_palette_stats},
     {NULL, NULL}
 };
 
@@ -78,5 +260,11 @@ int luaopen_graphics(lua_State* L) {
 
     // Registrar 'texture' global
     luaL_register(L, "texture", texture_lib);
+
+    // Registrar 'palette' global (atlas de paletas de las texturas indexadas)
+    luaL_register(L, "palette", palette_lib);
+
+    // Registrar 'graphics' global (estadísticas de render); queda como valor del módulo
+    luaL_register(L, "graphics", graphics_lib);
     return 1;
 }
@@ -15,9 +15,9 @@ static int map_key_to_button(int scancode) {
     }
 }
 
-// Lua: input.is_down(scancode)
-static int l_is_down(lua_State* L) {
-    int key = luaL_checkinteger(L, 1);
+// ABI C (FFI): 1 si la tecla (o su botón equivalente del mando) está pulsada
+extern "C" int xpp_input_is_down(int key) {
+    if (key < 0 || key >= SDL_NUM_SCANCODES) return 0;
 
     // 1. Chequear Teclado
     const Uint8* state = SDL_GetKeyboardState(NULL);
@@ -31,7 +31,13 @@ static int l_is_down(lua_State* L) {
         }
     }
 
-    lua_pushboolean(L, down);
+    return down ? 1 : 0;
+}
+
+// Lua: input.is_down(scancode)
+static int l_is_down(lua_State* L) {
+    int key = luaL_checkinteger(L, 1);
+    lua_pushboolean(L, xpp_input_is_down(key));
     return 1;
 }
 
@@ -0,0 +1,159 @@
+/**
+ * src/bindings/l_level.cpp
+ * Módulo 'xlv': niveles binarios por chunks con carga en streaming.
+ * La lógica de juego (sólidos, spawns) vive en scripts/core/level_stream.lua.
+ */
+
+#include "../engine.hpp"
+
+// Lua: xlv.open(path) -> info | nil, err
+// info = { tile_size, width, height, chunk_tiles, chunk_size, chunks_x, chunks_y, layers, tileset }
+static int l_xlv_open(lua_State* L) {
+    const char* path = luaL_checkstring(L, 1);
+    if (!level_stream_open(path)) {
+        lua_pushnil(L);
+        lua_pushstring(L, "Error loading level");
+        return 2;
+    }
+
+    const LevelInfo* info = level_stream_info();
+    lua_createtable(L, 0, 9);
+    lua_pushinteger(L, info->tile_size);
+    lua_setfield(L, -2, "tile_size");
+    lua_pushinteger(L, info->width);
+    lua_setfield(L, -2, "width");
+    lua_pushinteger(L, info->height);
+    lua_setfield(L, -2, "height");
+    lua_pushinteger(L, info->chunk_tiles);
+    lua_setfield(L, -2, "chunk_tiles");
+    lua_pushinteger(L, info->chunk_tiles * info->tile_size);
+    lua_setfield(L, -2, "chunk_size");
+    lua_pushinteger(L, info->chunks_x);
+    lua_setfield(L, -2, "chunks_x");
+    lua_pushinteger(L, info->chunks_y);
+    lua_setfield(L, -2, "chunks_y");
+    lua_pushinteger(L, info->layers);
+    lua_setfield(L, -2, "layers");
+    lua_pushstring(L, info->tileset.c_str());
+    lua_setfield(L, -2, "tileset");
+    return 1;
+}
+
+// Lua: xlv.close()
+static int l_xlv_close(lua_State* L) {
+    level_stream_close();
+    return 0;
+}
+
+static void push_id_list(lua_State* L, const std::vector<int>& ids) {
+    lua_createtable(L, (int)ids.size(), 0);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        lua_pushinteger(L, ids[i]);
+        lua_rawseti(L, -2, (int)i + 1);
+    }
+}
+
+// Lua: xlv.update(cam_x, cam_y, [radius=1]) -> loaded_ids, unloaded_ids
+// Los chunks visibles quedan residentes al volver; el anillo de 'radius' chunks
+// alrededor se lee en segundo plano.
+static int l_xlv_update(lua_State* L) {
+    float cam_x = luaL_checknumber(L, 1);
+    float cam_y = luaL_checknumber(L, 2);
+    int radius = luaL_optinteger(L, 3, 1);
+
+    std::vector<int> loaded, unloaded;
+    level_stream_update(cam_x, cam_y, radius, loaded, unloaded);
+    push_id_list(L, loaded);
+    push_id_list(L, unloaded);
+    return 2;
+}
+
+// Lua: xlv.chunk_solids(id) -> { {x, y, w, h}, ... }
+static int l_xlv_chunk_solids(lua_State* L) {
+    const LevelChunk* chunk = level_stream_chunk(luaL_checkinteger(L, 1));
+    if (!chunk) return luaL_argerror(L, 1, "chunk not loaded");
+
+    lua_createtable(L, (int)chunk->solids.size(), 0);
+    for (size_t i = 0; i < chunk->solids.size(); ++i) {
+        const LevelSolid& s = chunk->solids[i];
+        lua_createtable(L, 0, 4);
+        lua_pushinteger(L, s.x);
+        lua_setfield(L, -2, "x");
+        lua_pushinteger(L, s.y);
+        lua_setfield(L, -2, "y");
+        lua_pushinteger(L, s.w);
+        lua_setfield(L, -2, "w");
+        lua_pushinteger(L, s.h);
+        lua_setfield(L, -2, "h");
+        lua_rawseti(L, -2, (int)i + 1);
+    }
+    return 1;
+}
+
+// Lua: xlv.chunk_spawns(id) -> { {id, type, x, y}, ... }
+static int l_xlv_chunk_spawns(lua_State* L) {
+    const LevelChunk* chunk = level_stream_chunk(luaL_checkinteger(L, 1));
+    if (!chunk) return luaL_argerror(L, 1, "chunk not loaded");
+
+    lua_createtable(L, (int)chunk->spawns.size(), 0);
+    for (size_t i = 0; i < chunk->spawns.size(); ++i) {
+        const LevelSpawn& s = chunk->spawns[i];
+        lua_createtable(L, 0, 4);
+        lua_pushinteger(L, s.id);
+        lua_setfield(L, -2, "id");
+        lua_pushstring(L, s.type.c_str());
+        lua_setfield(L, -2, "type");
+        lua_pushinteger(L, s.x);
+        lua_setfield(L, -2, "x");
+        lua_pushinteger(L, s.y);
+        lua_setfield(L, -2, "y");
+        lua_rawseti(L, -2, (int)i + 1);
+    }
+    return 1;
+}
+
+// Lua: xlv.draw_tiles(tex_id, tex_w, tex_h, layer, cam_x, cam_y)
+// Emite los tiles visibles de la capa (0 = primera) en una sola llamada
+static int l_xlv_draw_tiles(lua_State* L) {
+    GLuint tex = (GLuint)luaL_checkinteger(L, 1);
+    int tex_w = luaL_checkinteger(L, 2);
+    int tex_h = luaL_checkinteger(L, 3);
+    int layer = luaL_checkinteger(L, 4);
+    float cam_x = luaL_checknumber(L, 5);
+    float cam_y = luaL_checknumber(L, 6);
+    level_stream_draw_tiles(tex, tex_w, tex_h, layer, cam_x, cam_y);
+    return 0;
+}
+
+// Lua: xlv.stats() -> { loaded, pending, async_loads, sync_loads, unloads }
+static int l_xlv_stats(lua_State* L) {
+    const LevelStreamStats& s = level_stream_stats();
+    lua_createtable(L, 0, 5);
+    lua_pushinteger(L, s.loaded);
+    lua_setfield(L, -2, "loaded");
+    lua_pushinteger(L, s.pending);
+    lua_setfield(L, -2, "pending");
+    lua_pushnumber(L, (lua_Number)s.async_loads);
+    lua_setfield(L, -2, "async_loads");
+    lua_pushnumber(L, (lua_Number)s.sync_loads);
+    lua_setfield(L, -2, "sync_loads");
+    lua_pushnumber(L, (lua_Number)s.unloads);
+    lua_setfield(L, -2, "unloads");
+    return 1;
+}
+
+static const luaL_Reg xlv_lib[] = {
+    {"open", l_xlv_open},
+    {"close", l_xlv_close},
+    {"update", l_xlv_update},
+    {"chunk_solids", l_xlv_chunk_solids},
+    {"chunk_spawns", l_xlv_chunk_spawns},
+    {"draw_tiles", l_xlv_draw_tiles},
+    {"stats", l_xlv_stats},
+    {NULL, NULL}
+};
+
+int luaopen_xlv(lua_State* L) {
+    luaL_register(L, "xlv", xlv_lib);
+    return 1;
+}
@@ -0,0 +1,58 @@
+/**
+ * src/bindings/l_memory.cpp
+ * Módulo 'memory': informe de memoria por categoría y presupuestos.
+ */
+
+#include "../engine.hpp"
+
+// Lua: memory.report()
+// Retorna { texture = {used, peak, budget}, sfx = {...}, ..., total = bytes }
+static int l_memory_report(lua_State* L) {
+    lua_createtable(L, 0, MEM_COUNT + 1);
+    for (int i = 0; i < MEM_COUNT; ++i) {
+        const MemCategoryStats& s = mem_stats((MemCategory)i);
+        lua_createtable(L, 0, 3);
+        lua_pushnumber(L, (lua_Number)s.used);
+        lua_setfield(L, -2, "used");
+        lua_pushnumber(L, (lua_Number)s.peak);
+        lua_setfield(L, -2, "peak");
+        lua_pushnumber(L, (lua_Number)s.budget);
+        lua_setfield(L, -2, "budget");
+        lua_setfield(L, -2, mem_category_name((MemCategory)i));
+    }
+    lua_pushnumber(L, (lua_Number)mem_total());
+    lua_setfield(L, -2, "total");
+    return 1;
+}
+
+// Lua: memory.set_budget(category, bytes)
+// category: "texture", "sfx", "music", "lua", "batch", "level", "bodies".
+// bytes = 0 quita el límite.
+static int l_memory_set_budget(lua_State* L) {
+    const char* name = luaL_checkstring(L, 1);
+    lua_Number bytes = luaL_checknumber(L, 2);
+
+    MemCategory cat = mem_category_from_name(name);
+    if (cat == MEM_COUNT) return luaL_argerror(L, 1, "unknown memory category");
+
+    mem_set_budget(cat, bytes > 0 ? (size_t)bytes : 0);
+    return 0;
+}
+
+// Lua: memory.total() -> bytes
+static int l_memory_total(lua_State* L) {
+    lua_pushnumber(L, (lua_Number)mem_total());
+    return 1;
+}
+
+static const luaL_Reg memory_lib[] = {
+    {"report", l_memory_report},
+    {"set_budget", l_memory_set_budget},
+    {"total", l_memory_total},
+    {NULL, NULL}
+};
+
+int luaopen_memory(lua_State* L) {
+    luaL_register(L, "memory", memory_lib);
+    return 1;
+}
@@ -0,0 +1,77 @@
+/**
+ * src/bindings/l_panic.cpp
+ * Estado Lua compartido por el motor y los benchmarks: manejador de pánico,
+ * polyfill de luaL_requiref y registro de todos los módulos nativos.
+ */
+
+#include "../engine.hpp"
+
+// Declaraciones forward de los módulos Lua (bindings)
+// SIN extern "C" – se compilan como C++
+int luaopen_util(lua_State* L);
+int luaopen_input(lua_State* L);
+int luaopen_audio(lua_State* L);
+int luaopen_graphics(lua_State* L);
+int luaopen_snapshot(lua_State* L);
+int luaopen_memory(lua_State* L);
+int luaopen_text(lua_State* L);
+int luaopen_debugdraw(lua_State* L);
+int luaopen_xlv(lua_State* L);
+int luaopen_collide(lua_State* L);
+
+// --- POLYFILL luaL_requiref (LuaJIT / Lua 5.1) ---
+void luaL_requiref(lua_State *L, const char *modname, lua_CFunction openf, int glb) {
+    lua_pushcfunction(L, openf);
+    lua_pushstring(L, modname);
+    lua_call(L, 1, 1);                // openf(modname) → tabla del módulo
+
+    lua_getfield(L, LUA_REGISTRYINDEX, "_LOADED");
+    lua_pushvalue(L, -2);             // copia del módulo
+    lua_setfield(L, -2, modname);    // _LOADED[modname] = módulo
+    lua_pop(L, 1);                   // sacar _LOADED
+
+    if (glb) {
+        lua_pushvalue(L, -1);        // copia del módulo
+        lua_setglobal(L, modname);   // _G[modname] = módulo
+    }
+    // El módulo permanece en la cima de la pila (como en Lua 5.2+)
+}
+
+// --- Manejador de pánico Lua ---
+int l_panic(lua_State* L) {
+    const char* err = lua_tostring(L, -1);
+    std::cerr << "\n========================================\n";
+    std::cerr << "!!! LUA PANIC !!!\n";
+    std::cerr << "Error: " << (err ? err : "desconocido") << "\n";
+    std::cerr << "========================================\n";
+    engine.running = false;
+    return 0;
+}
+
+// Registra todos los módulos nativos como globales (y en _LOADED)
+void open_engine_modules(lua_State* L) {
+    luaL_requiref(L, "util",   luaopen_util,   1);
+    lua_pop(L, 1);
+    luaL_requiref(L, "input",  luaopen_input,  1);
+    lua_pop(L, 1);
+    luaL_requiref(L, "audio",  luaopen_audio,  1);
+    lua_pop(L, 1);
+    // Módulo de gráficos (batch + texture)
+    luaL_requiref(L, "graphics", luaopen_graphics, 1);
+    lua_pop(L, 1);
+    // Snapshots del mundo (rewind / reintentos)
+    luaL_requiref(L, "snapshot", luaopen_snapshot, 1);
+    lua_pop(L, 1);
+    luaL_requiref(L, "memory", luaopen_memory, 1);
+    lua_pop(L, 1);
+    luaL_requiref(L, "text", luaopen_text, 1);
+    lua_pop(L, 1);
+    luaL_requiref(L, "debugdraw", luaopen_debugdraw, 1);
+    lua_pop(L, 1);
+    // Niveles .xlv en streaming
+    luaL_requiref(L, "xlv", luaopen_xlv, 1);
+    lua_pop(L, 1);
+    // Colisión continua (barridos de AABB)
+    luaL_requiref(L, "collide", luaopen_collide, 1);
+    lua_pop(L, 1);
+}
@@ -0,0 +1,546 @@
+/**
+ * src/bindings/l_snapshot.cpp
+ * Snapshots del mundo: serializa un grafo de tablas Lua a un arena binario
+ * compacto y lo reconstruye en un solo paso (rewind / reintento instantáneo).
+ *
+ * - Números, strings, booleanos y tablas se copian (respetando referencias
+ *   compartidas y ciclos).
+ * - Funciones, userdata, corrutinas, metatablas y tablas marcadas con
+ *   snapshot.share() se guardan por referencia ("anclas"): el snapshot solo
+ *   es válido dentro de la misma sesión del motor.
+ * - Snapshots consecutivos se guardan como delta (XOR + RLE) contra el
+ *   anterior, con un keyframe cada N capturas. Límite: el delta compara los
+ *   arenas byte a byte en el mismo offset, y el arena sigue el orden de
+ *   lua_next con ids de tabla por orden de aparición. Una entidad nueva o un
+ *   string que cambia de longitud desplaza todo lo que viene detrás, así que
+ *   cuando el mundo cambia de forma el delta se acerca a una copia completa.
+ *   Solo comprime bien los cambios de valor en una estructura estable.
+ * - restore() reconstruye tablas nuevas: las referencias guardadas fuera de la
+ *   raíz (locales de módulo, upvalues) siguen apuntando a las tablas viejas.
+ *   Solo las tablas registradas con rewind.track se restauran en su sitio.
+ * - Cada snapshot cuenta una referencia a sus anclas; al salir del anillo el
+ *   último que las usa, el registro las suelta y el GC puede recogerlas.
+ */
+
+#include "../engine.hpp"
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
+
+// Claves del registro Lua
+static const char* ANCHORS_KEY    = "xpp.snapshot.anchors";     // idx -> valor
+static const char* ANCHOR_IDS_KEY = "xpp.snapshot.anchor_ids";  // valor -> idx
+static const char* SHARED_KEY     = "xpp.snapshot.shared";      // tabla -> true
+
+// Anidamiento máximo de tablas (la recursión usa pila de C y de Lua)
+static const int MAX_DEPTH = 200;
+
+enum SnapTag : uint8_t {
+    TAG_NIL, TAG_FALSE, TAG_TRUE, TAG_NUMBER, TAG_STRING,
+    TAG_TABLE, TAG_REF, TAG_ANCHOR, TAG_END
+};
+
+struct Snapshot {
+    uint32_t id;
+    bool keyframe;
+    uint32_t raw_size;             // Tamaño del arena sin comprimir
+    std::vector<uint8_t> data;     // Arena (keyframe) o delta contra el anterior
+    std::vector<uint32_t> anchors; // Anclas que referencia (una vez cada una)
+};
+
+struct SnapshotRing {
+    std::deque<Snapshot> ring;
+    std::vector<uint8_t> last_raw; // Arena de la última captura (base del próximo delta)
+    uint32_t next_id = 1;
+    size_t capacity = 120;         // 2 minutos a 1 captura por segundo
+    int keyframe_interval = 10;
+    int since_keyframe = 0;
+
+    std::vector<uint32_t> anchor_refs;  // id de ancla -> snapshots que la usan
+    std::vector<uint32_t> free_anchors; // ids liberados, reutilizables
+};
+
+static SnapshotRing snaps;
+
+// ============================================================================
+// ARENA: ESCRITURA / LECTURA
+// ============================================================================
+
+struct Writer {
+    std::vector<uint8_t>& out;
+    std::unordered_map<const void*, uint32_t> tables; // tabla -> id de aparición
+    std::unordered_set<uint32_t> anchors;             // Anclas usadas en esta captura
+
+    void u8(uint8_t v) { out.push_back(v); }
+    void u32(uint32_t v) { bytes(&v, sizeof(v)); }
+    void f64(double v) { bytes(&v, sizeof(v)); }
+    void bytes(const void* p, size_t n) {
+        const uint8_t* b = (const uint8_t*)p;
+        out.insert(out.end(), b, b + n);
+    }
+};
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    bool ok(size_t n) const { return (size_t)(end - p) >= n; }
+    uint8_t u8() { return ok(1) ? *p++ : (uint8_t)TAG_END; }
+    uint32_t u32() { uint32_t v = 0; if (ok(4)) { memcpy(&v, p, 4); p += 4; } return v; }
+    double f64() { double v = 0; if (ok(8)) { memcpy(&v, p, 8); p += 8; } return v; }
+};
+
+// Devuelve el índice de ancla del valor en 'idx' (lo registra si es nuevo)
+static uint32_t anchor_value(lua_State* L, Writer& w, int idx) {
+    if (idx < 0) idx = lua_gettop(L) + idx + 1;
+    lua_getfield(L, LUA_REGISTRYINDEX, ANCHOR_IDS_KEY);
+    lua_pushvalue(L, idx);
+    lua_rawget(L, -2);
+    if (lua_isnumber(L, -1)) {
+        uint32_t id = (uint32_t)lua_tointeger(L, -1);
+        lua_pop(L, 2);
+        w.anchors.insert(id);
+        return id;
+    }
+    lua_pop(L, 1);
+
+    uint32_t id;
+    if (!snaps.free_anchors.empty()) {
+        id = snaps.free_anchors.back();
+        snaps.free_anchors.pop_back();
+    } else {
+        id = (uint32_t)snaps.anchor_refs.size() + 1;
+        snaps.anchor_refs.push_back(0);
+    }
+    w.anchors.insert(id);
+
+    lua_getfield(L, LUA_REGISTRYINDEX, ANCHORS_KEY);
+    lua_pushvalue(L, idx);
+    lua_rawseti(L, -2, id);
+    lua_pop(L, 1);
+
+    lua_pushvalue(L, idx);
+    lua_pushinteger(L, id);
+    lua_rawset(L, -3);
+    lua_pop(L, 1);
+    return id;
+}
+
+// Quita el ancla 'id' del registro (ningún snapshot la referencia ya)
+static void release_anchor(lua_State* L, uint32_t id) {
+    lua_getfield(L, LUA_REGISTRYINDEX, ANCHORS_KEY);
+    lua_rawgeti(L, -1, (int)id);
+    lua_getfield(L, LUA_REGISTRYINDEX, ANCHOR_IDS_KEY);
+    lua_pushvalue(L, -2);
+    lua_pushnil(L);
+    lua_rawset(L, -3);
+    lua_pop(L, 2);
+    lua_pushnil(L);
+    lua_rawseti(L, -2, (int)id);
+    lua_pop(L, 1);
+    snaps.free_anchors.push_back(id);
+}
+
+// Suelta las anclas de un snapshot que sale del anillo
+static void unref_anchors(lua_State* L, const std::vector<uint32_t>& anchors) {
+    for (uint32_t id : anchors) {
+        if (--snaps.anchor_refs[id - 1] == 0) release_anchor(L, id);
+    }
+}
+
+static bool is_shared(lua_State* L, int idx) {
+    lua_getfield(L, LUA_REGISTRYINDEX, SHARED_KEY);
+    lua_pushvalue(L, idx);
+    lua_rawget(L, -2);
+    bool shared = lua_toboolean(L, -1);
+    lua_pop(L, 2);
+    return shared;
+}
+
+// false si el grafo anida más de MAX_DEPTH tablas
+static bool write_value(lua_State* L, Writer& w, int idx, int depth) {
+    if (idx < 0) idx = lua_gettop(L) + idx + 1;
+
+    switch (lua_type(L, idx)) {
+        case LUA_TNIL:
+            w.u8(TAG_NIL);
+            return true;
+        case LUA_TBOOLEAN:
+            w.u8(lua_toboolean(L, idx) ? TAG_TRUE : TAG_FALSE);
+            return true;
+        case LUA_TNUMBER:
+            w.u8(TAG_NUMBER);
+            w.f64(lua_tonumber(L, idx));
+            return true;
+        case LUA_TSTRING: {
+            size_t len;
+            const char* str = lua_tolstring(L, idx, &len);
+            w.u8(TAG_STRING);
+            w.u32((uint32_t)len);
+            w.bytes(str, len);
+            return true;
+        }
+        case LUA_TTABLE: {
+            if (is_shared(L, idx)) break;
+
+            const void* key = lua_topointer(L, idx);
+            auto it = w.tables.find(key);
+            if (it != w.tables.end()) {
+                w.u8(TAG_REF);
+                w.u32(it->second);
+                return true;
+            }
+            if (depth >= MAX_DEPTH) return false;
+            luaL_checkstack(L, 4, "snapshot too deep");
+
+            uint32_t id = (uint32_t)w.tables.size();
+            w.tables[key] = id;
+            w.u8(TAG_TABLE);
+
+            // Metatabla (clase): siempre por referencia
+            if (lua_getmetatable(L, idx)) {
+                w.u8(TAG_ANCHOR);
+                w.u32(anchor_value(L, w, -1));
+                lua_pop(L, 1);
+            } else {
+                w.u8(TAG_NIL);
+            }
+
+            lua_pushnil(L);
+            while (lua_next(L, idx) != 0) {
+                if (!write_value(L, w, -2, depth + 1) || !write_value(L, w, -1, depth + 1)) {
+                    lua_pop(L, 2);
+                    return false;
+                }
+                lua_pop(L, 1);
+            }
+            w.u8(TAG_END);
+            return true;
+        }
+        default:
+            break;
+    }
+
+    // Funciones, userdata, corrutinas, cdata y tablas compartidas
+    w.u8(TAG_ANCHOR);
+    w.u32(anchor_value(L, w, idx));
+    return true;
+}
+
+// Reconstruye un valor en la cima de la pila. 'tables_idx' es una tabla temporal id -> tabla.
+static bool read_value(lua_State* L, Reader& r, int tables_idx, uint32_t& table_count, int depth) {
+    uint8_t tag = r.u8();
+    switch (tag) {
+        case TAG_NIL:    lua_pushnil(L); return true;
+        case TAG_FALSE:  lua_pushboolean(L, 0); return true;
+        case TAG_TRUE:   lua_pushboolean(L, 1); return true;
+        case TAG_NUMBER: lua_pushnumber(L, r.f64()); return true;
+        case TAG_STRING: {
+            uint32_t len = r.u32();
+            if (!r.ok(len)) return false;
+            lua_pushlstring(L, (const char*)r.p, len);
+            r.p += len;
+            return true;
+        }
+        case TAG_REF:
+            lua_rawgeti(L, tables_idx, (int)r.u32() + 1);
+            return true;
+        case TAG_ANCHOR:
+            lua_getfield(L, LUA_REGISTRYINDEX, ANCHORS_KEY);
+            lua_rawgeti(L, -1, (int)r.u32());
+            lua_remove(L, -2);
+            return true;
+        case TAG_TABLE: {
+            if (depth >= MAX_DEPTH) return false;
+            luaL_checkstack(L, 4, "snapshot too deep");
+            lua_newtable(L);
+            int t = lua_gettop(L);
+            lua_pushvalue(L, t);
+            lua_rawseti(L, tables_idx, (int)++table_count);
+
+            // Metatabla: se aplica al final para no disparar __newindex al rellenar
+            if (!read_value(L, r, tables_idx, table_count, depth + 1)) return false;
+            int mt = lua_gettop(L);
+
+            while (r.ok(1) && *r.p != TAG_END) {
+                if (!read_value(L, r, tables_idx, table_count, depth + 1)) return false;
+                if (!read_value(L, r, tables_idx, table_count, depth + 1)) return false;
+                if (lua_isnil(L, -2)) { lua_pop(L, 2); continue; }
+                lua_rawset(L, t);
+            }
+            if (r.u8() != TAG_END) return false;
+
+            if (lua_istable(L, mt)) lua_setmetatable(L, t);
+            else lua_pop(L, 1);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+// ============================================================================
+// COMPRESIÓN DELTA (XOR contra el arena anterior + RLE de ceros)
+// ============================================================================
+
+static void put_varint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static uint32_t get_varint(Reader& r) {
+    uint32_t v = 0;
+    int shift = 0;
+    while (r.ok(1) && shift < 32) {
+        uint8_t b = *r.p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+        shift += 7;
+    }
+    return v;
+}
+
+static inline uint8_t byte_at(const std::vector<uint8_t>& v, size_t i) {
+    return i < v.size() ? v[i] : 0;
+}
+
+// Secuencia de pares (ceros a saltar, literales XOR)
+static void delta_encode(const std::vector<uint8_t>& prev, const std::vector<uint8_t>& cur,
+                         std::vector<uint8_t>& out) {
+    size_t i = 0, n = cur.size();
+    while (i < n) {
+        size_t zeros = 0;
+        while (i + zeros < n && cur[i + zeros] == byte_at(prev, i + zeros)) zeros++;
+        i += zeros;
+        if (i >= n) break;
+
+        // El literal absorbe huecos cortos de ceros (más barato que abrir otro par)
+        size_t start = i, gap = 0;
+        while (i < n && gap < 4) {
+            if (cur[i] == byte_at(prev, i)) gap++;
+            else gap = 0;
+            i++;
+        }
+        i -= gap;
+
+        put_varint(out, (uint32_t)zeros);
+        put_varint(out, (uint32_t)(i - start));
+        for (size_t k = start; k < i; ++k) out.push_back(cur[k] ^ byte_at(prev, k));
+    }
+}
+
+static void delta_decode(const std::vector<uint8_t>& prev, const Snapshot& s, std::vector<uint8_t>& out) {
+    out.assign(s.raw_size, 0);
+    for (size_t k = 0; k < s.raw_size; ++k) out[k] = byte_at(prev, k);
+
+    Reader r{s.data.data(), s.data.data() + s.data.size()};
+    size_t i = 0;
+    while (r.ok(1)) {
+        i += get_varint(r);
+        uint32_t len = get_varint(r);
+        for (uint32_t k = 0; k < len && r.ok(1) && i < out.size(); ++k, ++i) out[i] ^= *r.p++;
+    }
+}
+
+// Arena completo del snapshot en la posición 'pos' del anillo
+static void decode_at(size_t pos, std::vector<uint8_t>& raw) {
+    size_t key = pos;
+    while (key > 0 && !snaps.ring[key].keyframe) key--;
+
+    raw = snaps.ring[key].data;
+    std::vector<uint8_t> next;
+    for (size_t i = key + 1; i <= pos; ++i) {
+        delta_decode(raw, snaps.ring[i], next);
+        raw.swap(next);
+    }
+}
+
+static void evict_oldest(lua_State* L) {
+    if (snaps.ring.size() > 1 && !snaps.ring[1].keyframe) {
+        // El nuevo primero pasa a keyframe: su delta apuntaba al que se va
+        std::vector<uint8_t> raw;
+        decode_at(1, raw);
+        snaps.ring[1].keyframe = true;
+        snaps.ring[1].data.swap(raw);
+    }
+    unref_anchors(L, snaps.ring.front().anchors);
+    snaps.ring.pop_front();
+}
+
+// ============================================================================
+// API LUA
+// ============================================================================
+
+// Cabecera del arena: estado del RNG del motor y del almacén de cuerpos
+// (los cuerpos FFI se anclan por referencia; sus campos viven en C)
+static void write_header(Writer& w) {
+    w.bytes(&engine.rng_state, sizeof(engine.rng_state));
+    body_store_save(w.out);
+}
+
+static void read_header(Reader& r) {
+    if (r.ok(sizeof(engine.rng_state))) {
+        memcpy(&engine.rng_state, r.p, sizeof(engine.rng_state));
+        r.p += sizeof(engine.rng_state);
+    }
+    // Cabecera inválida: el resto del arena tampoco se puede leer
+    if (!body_store_load(r.p, r.end)) r.p = r.end;
+}
+
+// Lua: snapshot.capture(root) -> id | nil, error
+static int l_snapshot_capture(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    std::vector<uint8_t> raw;
+    raw.reserve(snaps.last_raw.size());
+    Writer w{raw, {}, {}};
+    write_header(w);
+    if (!write_value(L, w, 1, 0)) {
+        // Anclas nuevas de la captura fallida: nadie las referencia
+        for (uint32_t id : w.anchors) {
+            if (snaps.anchor_refs[id - 1] == 0) release_anchor(L, id);
+        }
+        lua_pushnil(L);
+        lua_pushstring(L, "snapshot too deep");
+        return 2;
+    }
+
+    Snapshot s;
+    s.id = snaps.next_id++;
+    s.raw_size = (uint32_t)raw.size();
+    s.keyframe = snaps.ring.empty() || snaps.since_keyframe >= snaps.keyframe_interval;
+    s.anchors.assign(w.anchors.begin(), w.anchors.end());
+    for (uint32_t anchor : s.anchors) snaps.anchor_refs[anchor - 1]++;
+
+    if (s.keyframe) {
+        s.data = raw;
+        snaps.since_keyframe = 0;
+    } else {
+        delta_encode(snaps.last_raw, raw, s.data);
+        snaps.since_keyframe++;
+    }
+    snaps.last_raw.swap(raw);
+
+    snaps.ring.push_back(std::move(s));
+    while (snaps.ring.size() > snaps.capacity) evict_oldest(L);
+
+    lua_pushinteger(L, snaps.ring.back().id);
+    return 1;
+}
+
+// Lua: snapshot.restore(id) -> root | nil, error
+static int l_snapshot_restore(lua_State* L) {
+    uint32_t id = (uint32_t)luaL_checkinteger(L, 1);
+
+    size_t pos = 0;
+    while (pos < snaps.ring.size() && snaps.ring[pos].id != id) pos++;
+    if (pos == snaps.ring.size()) {
+        lua_pushnil(L);
+        lua_pushstring(L, "snapshot not found");
+        return 2;
+    }
+
+    std::vector<uint8_t> raw;
+    decode_at(pos, raw);
+
+    Reader r{raw.data(), raw.data() + raw.size()};
+    read_header(r);
+
+    lua_newtable(L);
+    int tables_idx = lua_gettop(L);
+    uint32_t table_count = 0;
+    if (!read_value(L, r, tables_idx, table_count, 0)) {
+        lua_settop(L, tables_idx - 1);
+        lua_pushnil(L);
+        lua_pushstring(L, "corrupt snapshot");
+        return 2;
+    }
+    lua_remove(L, tables_idx);
+    return 1;
+}
+
+// Lua: snapshot.share(tbl)
+// Marca una tabla (config, módulos, singletons) para guardarse por referencia
+static int l_snapshot_share(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+    lua_getfield(L, LUA_REGISTRYINDEX, SHARED_KEY);
+    lua_pushvalue(L, 1);
+    lua_pushboolean(L, 1);
+    lua_rawset(L, -3);
+    lua_pop(L, 1);
+    return 0;
+}
+
+// Lua: snapshot.configure(capacity, keyframe_interval)
+static int l_snapshot_configure(lua_State* L) {
+    lua_Integer capacity = luaL_optinteger(L, 1, (lua_Integer)snaps.capacity);
+    lua_Integer interval = luaL_optinteger(L, 2, snaps.keyframe_interval);
+    snaps.capacity = capacity < 1 ? 1 : (size_t)capacity;
+    snaps.keyframe_interval = interval < 1 ? 1 : (int)interval;
+    while (snaps.ring.size() > snaps.capacity) evict_oldest(L);
+    return 0;
+}
+
+// Lua: snapshot.range() -> oldest_id, newest_id (nil si está vacío)
+static int l_snapshot_range(lua_State* L) {
+    if (snaps.ring.empty()) {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushinteger(L, snaps.ring.front().id);
+    lua_pushinteger(L, snaps.ring.back().id);
+    return 2;
+}
+
+// Lua: snapshot.stats() -> count, stored_bytes, last_raw_bytes
+static int l_snapshot_stats(lua_State* L) {
+    size_t bytes = 0;
+    for (const Snapshot& s : snaps.ring) bytes += s.data.size();
+    lua_pushinteger(L, (lua_Integer)snaps.ring.size());
+    lua_pushinteger(L, (lua_Integer)bytes);
+    lua_pushinteger(L, (lua_Integer)snaps.last_raw.size());
+    return 3;
+}
+
+// Lua: snapshot.clear()
+// Vacía el anillo y suelta las anclas (referencias a funciones/metatablas)
+static int l_snapshot_clear(lua_State* L) {
+    snaps.ring.clear();
+    snaps.last_raw.clear();
+    snaps.since_keyframe = 0;
+    snaps.anchor_refs.clear();
+    snaps.free_anchors.clear();
+
+    lua_newtable(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, ANCHORS_KEY);
+    lua_newtable(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, ANCHOR_IDS_KEY);
+    return 0;
+}
+
+static const luaL_Reg snapshot_lib[] = {
+    {"capture", l_snapshot_capture},
+    {"restore", l_snapshot_restore},
+    {"share", l_snapshot_share},
+    {"configure", l_snapshot_configure},
+    {"range", l_snapshot_range},
+    {"stats", l_snapshot_stats},
+    {"clear", l_snapshot_clear},
+    {NULL, NULL}
+};
+
+int luaopen_snapshot(lua_State* L) {
+    lua_newtable(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, ANCHORS_KEY);
+    lua_newtable(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, ANCHOR_IDS_KEY);
+    lua_newtable(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, SHARED_KEY);
+
+    luaL_register(L, "snapshot", snapshot_lib);
+    return 1;
+}
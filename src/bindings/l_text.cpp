@@ -0,0 +1,110 @@
+/**
+ * src/bindings/l_text.cpp
+ * Módulo 'text': fuentes bitmap con layout nativo (una llamada por cadena).
+ */
+
+#include "../engine.hpp"
+
+// Lua: text.load(path_fnt) -> font_id | nil, err
+// Fuente BMFont en formato texto; el atlas (page 0) se busca junto al .fnt
+static int l_text_load(lua_State* L) {
+    const char* path = luaL_checkstring(L, 1);
+    int id = load_font(path);
+    if (id == 0) {
+        lua_pushnil(L);
+        lua_pushstring(L, "Error loading font");
+        return 2;
+    }
+    lua_pushinteger(L, id);
+    return 1;
+}
+
+// Lua: text.load_grid(path_png, cell_w, cell_h, [first_char=32]) -> font_id | nil, err
+// Fuente monoespaciada: rejilla de celdas en orden de codepoint
+static int l_text_load_grid(lua_State* L) {
+    const char* path = luaL_checkstring(L, 1);
+    int cell_w = luaL_checkinteger(L, 2);
+    int cell_h = luaL_checkinteger(L, 3);
+    int first = luaL_optinteger(L, 4, 32);
+
+    int id = load_font_grid(path, cell_w, cell_h, first);
+    if (id == 0) {
+        lua_pushnil(L);
+        lua_pushstring(L, "Error loading font");
+        return 2;
+    }
+    lua_pushinteger(L, id);
+    return 1;
+}
+
+// Lua: text.draw(font_id, str, x, y, [r, g, b, a])
+// Color opcional como en batch.draw (default blanco)
+static int l_text_draw(lua_State* L) {
+    int font = luaL_checkinteger(L, 1);
+    size_t len;
+    const char* str = luaL_checklstring(L, 2, &len);
+    float x = luaL_checknumber(L, 3);
+    float y = luaL_checknumber(L, 4);
+
+    float r = 1.0f, g = 1.0f, b = 1.0f, a = 1.0f;
+    if (lua_gettop(L) >= 8) {
+        r = luaL_checknumber(L, 5);
+        g = luaL_checknumber(L, 6);
+        b = luaL_checknumber(L, 7);
+        a = luaL_checknumber(L, 8);
+    }
+
+    draw_text(font, std::string(str, len), x, y, r, g, b, a);
+    return 0;
+}
+
+// Lua: text.measure(font_id, str) -> width, height
+static int l_text_measure(lua_State* L) {
+    int font = luaL_checkinteger(L, 1);
+    size_t len;
+    const char* str = luaL_checklstring(L, 2, &len);
+
+    float w = 0, h = 0;
+    if (!measure_text(font, std::string(str, len), &w, &h)) {
+        return luaL_argerror(L, 1, "invalid font");
+    }
+    lua_pushnumber(L, w);
+    lua_pushnumber(L, h);
+    return 2;
+}
+
+// Lua: text.line_height(font_id) -> px
+static int l_text_line_height(lua_State* L) {
+    lua_pushnumber(L, font_line_height(luaL_checkinteger(L, 1)));
+    return 1;
+}
+
+// Lua: text.stats() -> { cache_hits, cache_misses, glyphs_drawn, cached_runs }
+static int l_text_stats(lua_State* L) {
+    const TextStats& s = text_stats();
+    lua_createtable(L, 0, 4);
+    lua_pushnumber(L, (lua_Number)s.cache_hits);
+    lua_setfield(L, -2, "cache_hits");
+    lua_pushnumber(L, (lua_Number)s.cache_misses);
+    lua_setfield(L, -2, "cache_misses");
+    lua_pushnumber(L, (lua_Number)s.glyphs_drawn);
+    lua_setfield(L, -2, "glyphs_drawn");
+    lua_pushnumber(L, (lua_Number)s.cached_runs);
+    lua_setfield(L, -2, "cached_runs");
+    return 1;
+}
+
+static const luaL_Reg text_lib[] = {
+    {"load", l_text_load},
+    {"load_grid", l_text_load_grid},
+    {"draw", l_text_draw},
+    {"measure", l_text_measure},
+    {"line_height", l_text_line_height},
+    {"stats", l_text_stats},
+    {NULL, NULL}
+};
+
+int luaopen_text(lua_State* L) {
+    luaL_register(L, "text", text_lib);
+    return 1;
+}
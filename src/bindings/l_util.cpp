@@ -5,11 +5,30 @@
 
 #include "../engine.hpp"
 
+// ABI C (FFI)
+extern "C" Uint32 xpp_util_ticks(void) {
+    return SDL_GetTicks();
+}
+
+extern "C" double xpp_util_time(void) {
+    return (double)SDL_GetPerformanceCounter() / (double)SDL_GetPerformanceFrequency();
+}
+
+// Siguiente número del RNG del motor en [0, 1)
+extern "C" double xpp_util_random(void) {
+    Uint64 x = engine.rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    engine.rng_state = x;
+    return (double)((x * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
 // util.ticks()
 // Retorna los milisegundos transcurridos desde que inició el motor (SDL_GetTicks)
 // Útil para temporizadores o sincronización no crítica.
 static int l_util_ticks(lua_State* L) {
-    lua_pushinteger(L, SDL_GetTicks());
+    lua_pushinteger(L, xpp_util_ticks());
     return 1;
 }
 
@@ -17,9 +36,7 @@ static int l_util_ticks(lua_State* L) {
 // Retorna el tiempo en segundos con alta precisión (double).
 // Útil para profiling o cálculos físicos independientes del frame.
 static int l_util_time(lua_State* L) {
-    Uint64 counter = SDL_GetPerformanceCounter();
-    Uint64 freq = SDL_GetPerformanceFrequency();
-    lua_pushnumber(L, (double)counter / (double)freq);
+    lua_pushnumber(L, xpp_util_time());
     return 1;
 }
 
@@ -44,12 +61,80 @@ static int l_util_file_exists(lua_State* L) {
     return 1;
 }
 
+// util.random([m [, n]])
+// Igual que math.random pero con el RNG del motor, que se guarda en los snapshots
+// (math.random usa rand() de C y no se puede restaurar).
+static int l_util_random(lua_State* L) {
+    double r = xpp_util_random();
+
+    switch (lua_gettop(L)) {
+        case 0:
+            lua_pushnumber(L, r);
+            break;
+        case 1: {
+            lua_Integer m = luaL_checkinteger(L, 1);
+            luaL_argcheck(L, m >= 1, 1, "interval is empty");
+            lua_pushinteger(L, 1 + (lua_Integer)(r * (double)m));
+            break;
+        }
+        default: {
+            lua_Integer m = luaL_checkinteger(L, 1);
+            lua_Integer n = luaL_checkinteger(L, 2);
+            luaL_argcheck(L, m <= n, 2, "interval is empty");
+            lua_pushinteger(L, m + (lua_Integer)(r * (double)(n - m + 1)));
+            break;
+        }
+    }
+    return 1;
+}
+
+// util.randomseed(n)
+static int l_util_randomseed(lua_State* L) {
+    Uint64 seed = (Uint64)luaL_checknumber(L, 1);
+    engine.rng_state = seed ? seed : 0x9E3779B97F4A7C15ULL; // xorshift no admite estado 0
+    return 0;
+}
+
+// Nombre del modo tal como se escribe en config.system.pacing (también lo usa main.cpp)
+const char* pacing_mode_name(FramePacingMode mode) {
+    switch (mode) {
+        case PACING_VSYNC:    return "vsync";
+        case PACING_ADAPTIVE: return "adaptive";
+        case PACING_UNCAPPED: return "uncapped";
+        case PACING_CAPPED:   return "capped";
+    }
+    return "vsync";
+}
+
+// util.frame_stats()
+// Retorna una tabla con el modo de ritmo de frames y sus mediciones en milisegundos:
+// { mode, period_ms, work_ms, latency_ms, late_input }
+static int l_util_frame_stats(lua_State* L) {
+    const FramePacing& p = engine.pacing;
+
+    lua_createtable(L, 0, 5);
+    lua_pushstring(L, pacing_mode_name(p.mode));
+    lua_setfield(L, -2, "mode");
+    lua_pushnumber(L, p.period * 1000.0);
+    lua_setfield(L, -2, "period_ms");
+    lua_pushnumber(L, p.work_estimate * 1000.0);
+    lua_setfield(L, -2, "work_ms");
+    lua_pushnumber(L, p.latch_to_present * 1000.0);
+    lua_setfield(L, -2, "latency_ms");
+    lua_pushboolean(L, p.late_latch);
+    lua_setfield(L, -2, "late_input");
+    return 1;
+}
+
 // Registro del módulo
 static const luaL_Reg util_lib[] = {
     {"ticks", l_util_ticks},
     {"time", l_util_time},
     {"os", l_util_os},
     {"file_exists", l_util_file_exists},
+    {"frame_stats", l_util_frame_stats},
+    {"random", l_util_random},
+    {"randomseed", l_util_randomseed},
     {NULL, NULL}
 };
 
@@ -19,22 +19,61 @@
 const int INTERNAL_W = 256;
 const int INTERNAL_H = 224;
 
+// Modos de ritmo de frames (config.system.pacing)
+enum FramePacingMode {
+    PACING_VSYNC,      // Intervalo de swap 1
+    PACING_ADAPTIVE,   // Intervalo -1: sin tearing salvo cuando vamos tarde
+    PACING_UNCAPPED,   // Sin límite (benchmarks)
+    PACING_CAPPED      // Sin vsync, limitado a fps_limit con sleep + espera activa
+};
+
+struct FramePacing {
+    FramePacingMode mode = PACING_VSYNC;
+    int fps_limit = 60;
+    bool late_latch = false;       // Leer input y simular justo antes de _draw
+
+    double period = 1.0 / 60.0;    // Duración objetivo de un frame (refresco o fps_limit)
+    double spin_margin = 0.002;    // Últimos segundos de espera en spin (SDL_Delay es impreciso)
+    double next_deadline = 0.0;    // Instante objetivo del próximo present (modo capped)
+    double last_present = 0.0;     // Instante en que volvió el último SwapWindow
+
+    // Mediciones (segundos)
+    double work_estimate = 0.0;    // Coste estimado input+update+draw (conservador)
+    double latch_to_present = 0.0; // Latencia input -> present (media móvil)
+};
+
+// Nombre del modo tal como se escribe en config.system.pacing (l_util.cpp)
+const char* pacing_mode_name(FramePacingMode mode);
+
+// Entrada de la caché de SFX (último uso para el desalojo LRU)
+struct CachedSfx {
+    Mix_Chunk* chunk = nullptr;
+    Uint32 last_used = 0;
+};
+
 struct EngineState {
     SDL_Window* window = nullptr;
     SDL_GLContext gl_context = nullptr;
     lua_State* L = nullptr;
     bool running = true;
     bool debug_mode = true;
+    bool profile = false;        // XPP_PROFILE=1: informe por segundo en stdout
 
     // Control de Tiempo
     double accumulator = 0.0;
     const double MS_PER_UPDATE = 1.0 / 60.0;
     double delta_time = 0.0;
     Uint64 last_tick = 0;
+    FramePacing pacing;
+
+    // RNG determinista del juego (xorshift64*): forma parte de los snapshots
+    Uint64 rng_state = 0x9E3779B97F4A7C15ULL;
 
     // Audio
-    std::map<std::string, Mix_Chunk*> sfx_cache;
+    std::map<std::string, CachedSfx> sfx_cache;
     Mix_Music* current_music = nullptr;
+    size_t current_music_bytes = 0;
+    bool current_music_loop = false;
 
     // Input
     SDL_GameController* controller = nullptr;
@@ -44,15 +83,351 @@ struct EngineState {
 
 extern EngineState engine;
 
+// --- Estado Lua (l_panic.cpp) ---
+void luaL_requiref(lua_State *L, const char *modname, lua_CFunction openf, int glb);
+int l_panic(lua_State* L);
+void open_engine_modules(lua_State* L);
+
 // --- Funciones de Renderizado (Renderer API) ---
 void init_renderer();
 void flush_batch();
+// palette: fila del atlas de paletas; -1 = la propia de la textura (o RGBA directo)
 void draw_sprite(GLuint texture, float x, float y, float w, float h,
                  float u0, float v0, float u1, float v1,
-                 float r, float g, float b, float a);
+                 float r, float g, float b, float a, int palette = -1);
 void set_camera(float x, float y);
+void get_camera(float* x, float* y);
+void batch_forget_texture(GLuint texture);
+
+// --- ABI C para LuaJIT FFI (scripts/core/ffi_bindings.lua) ---
+// Versiones sin lua_State de las llamadas calientes: LuaJIT puede compilarlas
+// dentro de las trazas. Las firmas deben coincidir con los ffi.cdef del script.
+extern "C" {
+int xpp_input_is_down(int scancode);
+double xpp_util_time(void);
+Uint32 xpp_util_ticks(void);
+double xpp_util_random(void);
+void xpp_batch_draw(Uint32 texture, float x, float y, float w, float h,
+                    float u0, float v0, float u1, float v1,
+                    float r, float g, float b, float a, int palette);
+void xpp_batch_flush(void);
+void xpp_batch_set_camera(float x, float y);
+
+// Almacén de cuerpos (physics/body_store.cpp): arrays SoA indexados por slot
+typedef struct XppBodyStore {
+    Uint32 capacity, used, live;     // used = slots tocados alguna vez (límite de recorrido)
+    double *x, *y, *w, *h, *vx, *vy, *sub_x, *sub_y;
+    Uint32 *layer, *mask;
+    bool *is_sensor, *on_floor, *on_ceiling, *on_wall_left, *on_wall_right, *alive;
+    Uint16* generation;
+} XppBodyStore;
+
+XppBodyStore* xpp_body_store(void);
+Uint32 xpp_body_alloc(void);
+void xpp_body_free(Uint32 handle);
+int xpp_body_valid(Uint32 handle);
+void xpp_body_move_and_slide(Uint32 handle);
+void xpp_bodies_debug_draw(float cx, float cy);
+}
 
 // Funciones de Textura
+// Las texturas se cachean por ruta con conteo de referencias: cada load_texture
+// suma una referencia y release_texture la quita. Las que quedan sin referencias
+// pueden ser desalojadas (LRU) si se supera el presupuesto de VRAM.
 GLuint load_texture(const char* path, int* w, int* h);
+GLuint load_texture_indexed(const char* path, int* w, int* h, int* palette);
+void release_texture(GLuint texture);
+int touch_texture(GLuint texture);
+void free_all_textures();
+GLuint white_texture();
+
+// --- Paletas (palette.cpp) ---
+// Atlas RGBA de PALETTE_SIZE x PALETTE_ROWS en la unidad de textura 1: cada fila
+// es una paleta. Las texturas indexadas (R8) se colorean con la fila del vértice,
+// así que un cambio de paleta (flash de daño, colores de arma) no cambia de textura.
+const int PALETTE_SIZE = 256;
+const int PALETTE_ROWS = 64;
+
+void init_palettes();
+GLuint palette_texture();
+int palette_create(int from);
+int palette_from_sdl(const SDL_Palette* src);
+void palette_release(int row);
+bool palette_set(int row, int index, float r, float g, float b, float a);
+bool palette_get(int row, int index, float* rgba);
+int palette_count();
+void palette_upload();
+
+// --- Audio (audio/mixer.cpp) ---
+// config.audio: con low_latency el buffer es pequeño (back-off automático si hay
+// underruns) y los SFX se mezclan en el callback en la muestra de su tick de update.
+struct AudioConfig {
+    bool low_latency = false;
+    int frequency = 44100;
+    int buffer = 2048;           // Frames por buffer del dispositivo
+    int max_buffer = 2048;       // Tope del back-off
+    int channels = 32;           // Canales de SDL_mixer (modo clásico)
+    int underrun_limit = 3;      // Underruns por segundo que provocan back-off
+};
+
+struct AudioStats {
+    bool open = false;
+    bool scheduled = false;      // SFX planificados por muestra
+    int frequency = 0;
+    int buffer = 0;
+    double buffer_ms = 0.0;
+    double latency_ms = 0.0;     // Disparo -> salida (media móvil)
+    double max_latency_ms = 0.0;
+    Uint64 underruns = 0;        // Callbacks que llegaron tarde
+    Uint32 backoffs = 0;
+    Uint64 triggers = 0;
+    Uint64 late_triggers = 0;    // Llegaron después de su muestra: suenan ya
+    Uint64 voices_stolen = 0;
+    int voices = 0;
+};
+
+bool audio_open(const AudioConfig& config);
+void audio_close();
+void audio_update();
+void audio_set_tick_time(double time);
+void audio_play(Mix_Chunk* chunk);
+bool audio_chunk_in_use(Mix_Chunk* chunk);
+void audio_set_sfx_volume(int volume);
+void audio_free_sfx();
+AudioStats audio_stats();
+std::string audio_report_line();
+
+// --- Estadísticas de Render (render_stats.cpp) ---
+// Contadores por frame + tiempo GPU por pasada (GL_TIME_ELAPSED, leído unos
+// frames después para no bloquear). render_stats() devuelve el último frame cerrado.
+enum RenderPass {
+    RENDER_PASS_SCENE,   // Clear + batch (todo lo que dibuja _draw)
+    RENDER_PASS_DEBUG,   // Primitivas de debug draw
+    RENDER_PASS_COUNT
+};
+
+enum FlushReason {
+    FLUSH_EXPLICIT,      // batch.flush() / fin de frame
+    FLUSH_TEXTURE,       // Cambio de textura
+    FLUSH_FULL,          // Batch lleno
+    FLUSH_CAMERA,        // Cambio de cámara (nueva proyección)
+    FLUSH_REASON_COUNT
+};
+
+struct RenderFrameStats {
+    Uint32 draw_calls = 0;
+    Uint32 vertices = 0;
+    Uint32 flushes = 0;                          // Flushes con geometría
+    Uint32 flush_reasons[FLUSH_REASON_COUNT] = {0};
+    Uint32 texture_binds = 0;                    // glBindTexture emitidos
+    size_t bytes_uploaded = 0;
+    double gpu_ms[RENDER_PASS_COUNT] = {0};      // Con unos frames de retraso
+    bool gpu_valid[RENDER_PASS_COUNT] = {};      // false: pasada no emitida o descartada (gpu_ms = 0)
+    Uint64 gpu_dropped = 0;                      // Resultados no listos a tiempo (acumulado)
+};
+
+void init_render_stats();
+void render_stats_begin_frame();
+void render_stats_end_frame();
+void render_pass_begin(RenderPass pass);
+void render_pass_end();
+void render_stats_draw(Uint32 vertices, size_t bytes_uploaded);
+void render_stats_upload(size_t bytes);
+void render_stats_flush(FlushReason reason);
+void render_stats_texture_bind();
+const RenderFrameStats& render_stats();
+const char* render_pass_name(RenderPass pass);
+std::string render_report_line();
+
+// --- Debug Draw (debug_draw.cpp) ---
+// Primitivas sin textura en coordenadas de mundo (cámara del batch), con su propio
+// shader y buffer; se dibujan después del batch principal. Con XPP_DEBUG_DRAW=0
+// (make DEBUG_DRAW=0) el módulo se compila vacío; en runtime, debug_draw_enabled().
+#ifndef XPP_DEBUG_DRAW
+#define XPP_DEBUG_DRAW 1
+#endif
+
+struct DebugDrawStats {
+    Uint32 primitives = 0;   // Último frame
+    Uint32 vertices = 0;
+};
+
+#if XPP_DEBUG_DRAW
+void init_debug_draw();
+bool debug_draw_enabled();
+void debug_draw_set_enabled(bool enabled);
+void debug_draw_rect(float x, float y, float w, float h, float r, float g, float b, float a);
+void debug_draw_outline(float x, float y, float w, float h, float r, float g, float b, float a);
+void debug_draw_line(float x0, float y0, float x1, float y1, float r, float g, float b, float a);
+void debug_draw_cross(float x, float y, float size, float r, float g, float b, float a);
+void debug_draw_flush();
+const DebugDrawStats& debug_draw_stats();
+#else
+// Compilado fuera: llamadas vacías que el compilador elimina
+inline void init_debug_draw() {}
+inline bool debug_draw_enabled() { return false; }
+inline void debug_draw_set_enabled(bool) {}
+inline void debug_draw_rect(float, float, float, float, float, float, float, float) {}
+inline void debug_draw_outline(float, float, float, float, float, float, float, float) {}
+inline void debug_draw_line(float, float, float, float, float, float, float, float) {}
+inline void debug_draw_cross(float, float, float, float, float, float, float) {}
+inline void debug_draw_flush() {}
+inline const DebugDrawStats& debug_draw_stats() { static DebugDrawStats none; return none; }
+#endif
+
+// --- Texto Bitmap (font.cpp) ---
+// Fuentes: id > 0, 0 = error. draw_text cachea el layout por (fuente, texto).
+struct TextStats {
+    Uint64 cache_hits = 0;
+    Uint64 cache_misses = 0;
+    Uint64 glyphs_drawn = 0;
+    size_t cached_runs = 0;
+};
+
+int load_font(const char* path);
+int load_font_grid(const char* path, int cell_w, int cell_h, int first);
+void draw_text(int font, const std::string& text, float x, float y,
+               float r, float g, float b, float a);
+bool measure_text(int font, const std::string& text, float* w, float* h);
+float font_line_height(int font);
+void text_frame_end();
+const TextStats& text_stats();
+void free_all_fonts();
+
+// --- Niveles por chunks (level/stream.cpp) ---
+// Formato .xlv (tools/levelpack.py): cabecera + directorio de chunks; cada chunk
+// trae sus capas de tiles (RLE), sólidos y puntos de spawn. Solo se mantienen
+// cargados los chunks cerca de la cámara; los vecinos se leen en un hilo aparte.
+struct LevelInfo {
+    int tile_size = 16;
+    int width = 0, height = 0;       // En tiles
+    int chunk_tiles = 16;            // Lado del chunk en tiles
+    int chunks_x = 0, chunks_y = 0;
+    int layers = 0;
+    std::string tileset;
+};
+
+struct LevelSolid {
+    int x, y, w, h;                  // Píxeles de mundo
+};
+
+struct LevelSpawn {
+    Uint32 id;                       // Estable entre cargas del chunk
+    int x, y;
+    std::string type;
+};
+
+struct LevelChunk {
+    int id = -1;                     // cy * chunks_x + cx
+    int cx = 0, cy = 0;
+    std::vector<Uint16> tiles;       // layers * chunk_tiles^2 (0 = vacío)
+    std::vector<LevelSolid> solids;
+    std::vector<LevelSpawn> spawns;
+    size_t bytes = 0;
+};
+
+struct LevelStreamStats {
+    Uint32 loaded = 0;               // Chunks residentes
+    Uint32 pending = 0;              // En cola del hilo lector
+    Uint64 async_loads = 0;
+    Uint64 sync_loads = 0;           // Chunks visibles que no llegaron a tiempo
+    Uint64 unloads = 0;
+};
+
+bool level_stream_open(const char* path);
+void level_stream_close();
+const LevelInfo* level_stream_info();
+void level_stream_update(float cam_x, float cam_y, int radius,
+                         std::vector<int>& loaded, std::vector<int>& unloaded);
+const LevelChunk* level_stream_chunk(int id);
+void level_stream_draw_tiles(GLuint texture, int tex_w, int tex_h, int layer, float cam_x, float cam_y);
+const LevelStreamStats& level_stream_stats();
+
+// --- Colisión continua (physics/collide.cpp) ---
+// Barrido de AABB: t en [0, 1) es la fracción del desplazamiento hasta el contacto.
+// hit_overlap: un cuerpo que ya empieza solapado choca en t = 0 (si no, se ignora).
+struct CollideRect {
+    float x, y, w, h;
+};
+
+struct SweepHit {
+    float t = 1.0f;
+    float nx = 0.0f, ny = 0.0f;  // Normal de la cara tocada
+    int index = -1;              // Sólido tocado (-1 = ninguno)
+};
+
+struct CollideStats {
+    Uint64 sweeps = 0;
+    Uint64 candidates = 0;       // Pares probados tras la rejilla
+    Uint64 resyncs = 0;
+    size_t solids = 0;
+};
+
+bool sweep_aabb(const CollideRect& a, float dx, float dy, const CollideRect& b,
+                bool hit_overlap, SweepHit* hit);
+void collide_set_solids(std::vector<CollideRect>&& solids);
+bool collide_sweep(const CollideRect& box, float dx, float dy, bool hit_overlap, SweepHit* out);
+const CollideStats& collide_stats();
+const CollideRect& collide_solid(int index);
+
+// --- Almacén de Cuerpos (physics/body_store.cpp) ---
+// Capacidad fija: los punteros exportados a FFI no cambian nunca.
+// Handle = (generación << 16) | slot, así que la capacidad no pasa de 65535.
+const Uint32 BODY_CAPACITY = 4096;
+
+bool body_valid(Uint32 handle);
+// Estado de los cuerpos dentro de un snapshot (l_snapshot.cpp)
+void body_store_save(std::vector<uint8_t>& out);
+bool body_store_load(const uint8_t*& p, const uint8_t* end);
+
+// --- Contabilidad de Memoria (memory.cpp) ---
+enum MemCategory {
+    MEM_TEXTURE,   // VRAM estimada (w * h * 4)
+    MEM_SFX,       // Mix_Chunk decodificados
+    MEM_MUSIC,     // Tamaño del archivo de música actual
+    MEM_LUA,       // Heap de Lua (lua_gc COUNT)
+    MEM_BATCH,     // Buffers del batch (CPU + VBO)
+    MEM_LEVEL,     // Chunks de nivel residentes
+    MEM_BODIES,    // Arrays del almacén de cuerpos
+    MEM_COUNT
+};
+
+struct MemCategoryStats {
+    size_t used = 0;
+    size_t peak = 0;
+    size_t budget = 0;   // 0 = sin límite
+};
+
+// Desalojador de una caché: intenta liberar 'bytes' y devuelve lo liberado
+typedef size_t (*MemEvictFn)(size_t bytes);
+
+void mem_track(MemCategory cat, long long delta);
+void mem_set(MemCategory cat, size_t bytes);
+void mem_set_budget(MemCategory cat, size_t bytes);
+void mem_set_evictor(MemCategory cat, MemEvictFn fn);
+const MemCategoryStats& mem_stats(MemCategory cat);
+const char* mem_category_name(MemCategory cat);
+MemCategory mem_category_from_name(const char* name);
+size_t mem_total();
+void mem_frame_update();
+std::string mem_report_line();
+
+// --- Caché de Estado GL (gl_state.cpp) ---
+// Contadores acumulados: llamadas GL emitidas vs. evitadas por la caché
+struct GLStateStats {
+    Uint64 issued = 0;
+    Uint64 skipped = 0;
+};
+
+void gl_use_program(GLuint program);
+void gl_bind_vertex_array(GLuint vao);
+void gl_bind_array_buffer(GLuint vbo);
+void gl_bind_texture(GLuint unit, GLuint texture);
+// Selecciona la unidad activa aunque su textura ya esté enlazada (antes de glTex*Image*)
+void gl_active_texture(GLuint unit);
+GLint gl_uniform_location(GLuint program, const char* name);
+void gl_state_forget_texture(GLuint texture);
+void gl_state_invalidate();
+const GLStateStats& gl_state_stats();
 
 #endif
@@ -0,0 +1,440 @@
+/**
+ * src/level/stream.cpp
+ * Carga por streaming de niveles .xlv (ver tools/levelpack.py).
+ *
+ * Formato (little-endian):
+ *   "XLV1" u16 version, u16 tile_size, u32 width, u32 height (tiles),
+ *   u16 chunk_tiles, u16 layers, u32 chunks_x, u32 chunks_y,
+ *   u16 len_tileset, u16 reservado (cabecera de 32 bytes), tileset,
+ *   directorio [chunks_x * chunks_y] { u32 offset, u32 size } (offset absoluto)
+ * Chunk:
+ *   por capa: pares RLE (u16 cuenta, u16 tile) hasta chunk_tiles^2
+ *   u16 n + n * { i32 x, i32 y, u16 w, u16 h }              sólidos
+ *   u16 n + n * { u32 id, i32 x, i32 y, u8 len, tipo }      spawns
+ *
+ * El hilo lector decodifica los chunks del anillo de precarga; los que ya son
+ * visibles y aún no llegaron se leen en el hilo principal (sync_loads).
+ */
+
+#include "../engine.hpp"
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+struct ChunkEntry {
+    Uint32 offset = 0;
+    Uint32 size = 0;
+};
+
+struct LevelStreamState {
+    LevelInfo info;
+    std::string path;
+    std::vector<ChunkEntry> directory;
+    FILE* file = nullptr;                      // Solo hilo principal (cargas síncronas)
+    bool open = false;
+
+    std::unordered_map<int, std::unique_ptr<LevelChunk>> loaded;
+    std::set<int> requested;                   // Pedidos al hilo lector sin recoger
+    LevelStreamStats stats;
+
+    // Hilo lector
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<int> queue;                     // Pedidos pendientes
+    std::vector<std::unique_ptr<LevelChunk>> done;
+    bool quit = false;
+};
+
+static LevelStreamState ls;
+
+// --- Lectura little-endian sobre un buffer ---
+struct Reader {
+    const Uint8* p;
+    const Uint8* end;
+    bool ok = true;
+
+    bool need(size_t n) {
+        if ((size_t)(end - p) < n) ok = false;
+        return ok;
+    }
+    Uint8 u8() {
+        if (!need(1)) return 0;
+        return *p++;
+    }
+    Uint16 u16() {
+        if (!need(2)) return 0;
+        Uint16 v = (Uint16)(p[0] | (p[1] << 8));
+        p += 2;
+        return v;
+    }
+    Uint32 u32() {
+        if (!need(4)) return 0;
+        Uint32 v = (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+        p += 4;
+        return v;
+    }
+    Sint32 i32() { return (Sint32)u32(); }
+    std::string str(size_t n) {
+        if (!need(n)) return "";
+        std::string s((const char*)p, n);
+        p += n;
+        return s;
+    }
+};
+
+static bool read_at(FILE* f, Uint32 offset, Uint32 size, std::vector<Uint8>& out) {
+    out.resize(size);
+    if (fseek(f, (long)offset, SEEK_SET) != 0) return false;
+    return fread(out.data(), 1, size, f) == size;
+}
+
+// Decodifica un chunk desde su archivo (cada hilo usa su propio FILE*)
+static std::unique_ptr<LevelChunk> decode_chunk(FILE* f, int id) {
+    auto chunk = std::make_unique<LevelChunk>();
+    chunk->id = id;
+    chunk->cx = id % ls.info.chunks_x;
+    chunk->cy = id / ls.info.chunks_x;
+
+    const ChunkEntry& entry = ls.directory[id];
+    if (entry.size == 0) return chunk;   // Chunk vacío: existe pero no trae datos
+
+    std::vector<Uint8> data;
+    if (!read_at(f, entry.offset, entry.size, data)) {
+        std::cerr << "[LEVEL] Error leyendo chunk " << id << std::endl;
+        return chunk;
+    }
+    Reader r{data.data(), data.data() + data.size()};
+
+    size_t per_layer = (size_t)ls.info.chunk_tiles * ls.info.chunk_tiles;
+    chunk->tiles.assign(per_layer * ls.info.layers, 0);
+    for (int layer = 0; layer < ls.info.layers && r.ok; ++layer) {
+        size_t pos = 0;
+        while (pos < per_layer && r.ok) {
+            Uint16 count = r.u16();
+            Uint16 tile = r.u16();
+            if (count == 0 || pos + count > per_layer) {
+                r.ok = false;
+                break;
+            }
+            std::fill_n(chunk->tiles.begin() + layer * per_layer + pos, count, tile);
+            pos += count;
+        }
+    }
+
+    Uint16 solids = r.u16();
+    for (Uint16 i = 0; i < solids && r.ok; ++i) {
+        LevelSolid s;
+        s.x = r.i32();
+        s.y = r.i32();
+        s.w = r.u16();
+        s.h = r.u16();
+        chunk->solids.push_back(s);
+    }
+
+    Uint16 spawns = r.u16();
+    for (Uint16 i = 0; i < spawns && r.ok; ++i) {
+        LevelSpawn s;
+        s.id = r.u32();
+        s.x = r.i32();
+        s.y = r.i32();
+        s.type = r.str(r.u8());
+        chunk->spawns.push_back(s);
+    }
+
+    if (!r.ok) std::cerr << "[LEVEL] Chunk " << id << " corrupto en " << ls.path << std::endl;
+
+    chunk->bytes = sizeof(LevelChunk) + chunk->tiles.size() * sizeof(Uint16)
+                 + chunk->solids.size() * sizeof(LevelSolid)
+                 + chunk->spawns.size() * sizeof(LevelSpawn);
+    return chunk;
+}
+
+static void worker_main(std::string path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        std::cerr << "[LEVEL] El hilo lector no pudo abrir " << path << std::endl;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(ls.mutex);
+    while (true) {
+        ls.wake.wait(lock, [] { return ls.quit || !ls.queue.empty(); });
+        if (ls.quit) break;
+
+        int id = ls.queue.front();
+        ls.queue.pop_front();
+
+        // Decodificar sin el lock: el hilo principal sigue encolando/recogiendo
+        lock.unlock();
+        std::unique_ptr<LevelChunk> chunk = decode_chunk(f, id);
+        lock.lock();
+        ls.done.push_back(std::move(chunk));
+    }
+    fclose(f);
+}
+
+void level_stream_close() {
+    if (ls.worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(ls.mutex);
+            ls.quit = true;
+        }
+        ls.wake.notify_all();
+        ls.worker.join();
+    }
+    if (ls.file) fclose(ls.file);
+
+    for (auto& [id, chunk] : ls.loaded) mem_track(MEM_LEVEL, -(long long)chunk->bytes);
+
+    ls.file = nullptr;
+    ls.open = false;
+    ls.quit = false;
+    ls.info = LevelInfo();
+    ls.directory.clear();
+    ls.loaded.clear();
+    ls.requested.clear();
+    ls.queue.clear();
+    ls.done.clear();
+    ls.stats = LevelStreamStats();
+}
+
+bool level_stream_open(const char* path) {
+    level_stream_close();
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        std::cerr << "[LEVEL] No se pudo abrir " << path << std::endl;
+        return false;
+    }
+
+    // Cabecera fija (32 bytes) + nombre del tileset
+    Uint8 head[32];
+    if (fread(head, 1, sizeof(head), f) != sizeof(head) || memcmp(head, "XLV1", 4) != 0) {
+        std::cerr << "[LEVEL] " << path << " no es un nivel .xlv" << std::endl;
+        fclose(f);
+        return false;
+    }
+    Reader r{head + 4, head + sizeof(head)};
+    Uint16 version = r.u16();
+    LevelInfo info;
+    info.tile_size = r.u16();
+    info.width = (int)r.u32();
+    info.height = (int)r.u32();
+    info.chunk_tiles = r.u16();
+    info.layers = r.u16();
+    info.chunks_x = (int)r.u32();
+    info.chunks_y = (int)r.u32();
+    Uint16 name_len = r.u16();
+    r.u16();   // reservado
+
+    if (version != 1 || info.chunk_tiles == 0 || info.tile_size == 0) {
+        std::cerr << "[LEVEL] " << path << ": versión o cabecera no soportada" << std::endl;
+        fclose(f);
+        return false;
+    }
+
+    // Las dimensiones vienen del archivo: el directorio (8 bytes por chunk) tiene
+    // que caber en él antes de reservar nada
+    fseek(f, 0, SEEK_END);
+    long file_end = ftell(f);
+    Uint64 file_size = file_end > 0 ? (Uint64)file_end : 0;
+    Uint64 chunk_count = (Uint64)(Uint32)info.chunks_x * (Uint32)info.chunks_y;
+    Uint64 dir_size = (Uint64)name_len + chunk_count * 8;
+    if (info.chunks_x <= 0 || info.chunks_y <= 0 || chunk_count > (Uint64)INT32_MAX ||
+        sizeof(head) + dir_size > file_size) {
+        std::cerr << "[LEVEL] " << path << ": directorio fuera del archivo ("
+                  << info.chunks_x << "x" << info.chunks_y << " chunks)" << std::endl;
+        fclose(f);
+        return false;
+    }
+
+    std::vector<Uint8> rest;
+    if (!read_at(f, sizeof(head), (Uint32)dir_size, rest)) {
+        std::cerr << "[LEVEL] " << path << ": directorio truncado" << std::endl;
+        fclose(f);
+        return false;
+    }
+    Reader dir{rest.data(), rest.data() + rest.size()};
+    info.tileset = dir.str(name_len);
+    ls.directory.resize((size_t)chunk_count);
+    for (ChunkEntry& e : ls.directory) {
+        e.offset = dir.u32();
+        e.size = dir.u32();
+        if ((Uint64)e.offset + e.size > file_size) {
+            std::cerr << "[LEVEL] " << path << ": chunk fuera del archivo" << std::endl;
+            ls.directory.clear();
+            fclose(f);
+            return false;
+        }
+    }
+
+    ls.info = info;
+    ls.path = path;
+    ls.file = f;
+    ls.open = true;
+    ls.worker = std::thread(worker_main, ls.path);
+    return true;
+}
+
+const LevelInfo* level_stream_info() {
+    return ls.open ? &ls.info : nullptr;
+}
+
+const LevelChunk* level_stream_chunk(int id) {
+    auto it = ls.loaded.find(id);
+    return it != ls.loaded.end() ? it->second.get() : nullptr;
+}
+
+const LevelStreamStats& level_stream_stats() {
+    return ls.stats;
+}
+
+static void make_resident(std::unique_ptr<LevelChunk> chunk, std::vector<int>& loaded) {
+    int id = chunk->id;
+    mem_track(MEM_LEVEL, (long long)chunk->bytes);
+    ls.loaded[id] = std::move(chunk);
+    loaded.push_back(id);
+}
+
+// Rango de chunks [x0, x1] x [y0, y1] que toca la vista ampliada 'margin' chunks
+static void chunk_range(float cam_x, float cam_y, int margin, int& x0, int& y0, int& x1, int& y1) {
+    float size = (float)(ls.info.chunk_tiles * ls.info.tile_size);
+    x0 = std::max(0, (int)std::floor(cam_x / size) - margin);
+    y0 = std::max(0, (int)std::floor(cam_y / size) - margin);
+    x1 = std::min(ls.info.chunks_x - 1, (int)std::floor((cam_x + INTERNAL_W - 1) / size) + margin);
+    y1 = std::min(ls.info.chunks_y - 1, (int)std::floor((cam_y + INTERNAL_H - 1) / size) + margin);
+}
+
+// Una vez por frame con la cámara: recoge lo que leyó el hilo, pide el anillo de
+// 'radius' chunks alrededor de la vista y descarga lo que quedó a más de radius + 1
+// (histéresis para no cargar/descargar en el borde).
+void level_stream_update(float cam_x, float cam_y, int radius,
+                         std::vector<int>& loaded, std::vector<int>& unloaded) {
+    if (!ls.open) return;
+    radius = std::max(0, radius);
+
+    int vx0, vy0, vx1, vy1;   // Visibles: deben estar residentes este frame
+    int wx0, wy0, wx1, wy1;   // Precarga
+    int kx0, ky0, kx1, ky1;   // Se conservan
+    chunk_range(cam_x, cam_y, 0, vx0, vy0, vx1, vy1);
+    chunk_range(cam_x, cam_y, radius, wx0, wy0, wx1, wy1);
+    chunk_range(cam_x, cam_y, radius + 1, kx0, ky0, kx1, ky1);
+
+    auto inside = [](int id, int x0, int y0, int x1, int y1) {
+        int cx = id % ls.info.chunks_x, cy = id / ls.info.chunks_x;
+        return cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1;
+    };
+
+    // 1. Recoger lo que terminó el hilo lector
+    std::vector<std::unique_ptr<LevelChunk>> done;
+    {
+        std::lock_guard<std::mutex> lock(ls.mutex);
+        done.swap(ls.done);
+    }
+    for (auto& chunk : done) {
+        ls.requested.erase(chunk->id);
+        if (ls.loaded.count(chunk->id) || !inside(chunk->id, kx0, ky0, kx1, ky1)) continue;
+        ls.stats.async_loads++;
+        make_resident(std::move(chunk), loaded);
+    }
+
+    // 2. Descargar lo que quedó lejos
+    for (auto it = ls.loaded.begin(); it != ls.loaded.end();) {
+        if (!inside(it->first, kx0, ky0, kx1, ky1)) {
+            mem_track(MEM_LEVEL, -(long long)it->second->bytes);
+            unloaded.push_back(it->first);
+            ls.stats.unloads++;
+            it = ls.loaded.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 3. Visibles que faltan: lectura síncrona (al abrir el nivel o tras un salto)
+    for (int cy = vy0; cy <= vy1; ++cy) {
+        for (int cx = vx0; cx <= vx1; ++cx) {
+            int id = cy * ls.info.chunks_x + cx;
+            if (ls.loaded.count(id)) continue;
+            ls.stats.sync_loads++;
+            make_resident(decode_chunk(ls.file, id), loaded);
+        }
+    }
+
+    // 4. Pedir el anillo de precarga al hilo lector
+    std::vector<int> wanted;
+    for (int cy = wy0; cy <= wy1; ++cy) {
+        for (int cx = wx0; cx <= wx1; ++cx) {
+            int id = cy * ls.info.chunks_x + cx;
+            if (!ls.loaded.count(id) && !ls.requested.count(id)) wanted.push_back(id);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(ls.mutex);
+        // Pedidos que ya no interesan se descartan antes de leerlos
+        for (auto it = ls.queue.begin(); it != ls.queue.end();) {
+            if (!inside(*it, wx0, wy0, wx1, wy1)) {
+                ls.requested.erase(*it);
+                it = ls.queue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (int id : wanted) {
+            ls.queue.push_back(id);
+            ls.requested.insert(id);
+        }
+        ls.stats.pending = (Uint32)ls.queue.size();
+    }
+    if (!wanted.empty()) ls.wake.notify_one();
+
+    ls.stats.loaded = (Uint32)ls.loaded.size();
+}
+
+// Dibuja una capa de tiles de los chunks residentes que tocan la pantalla.
+// El tileset es una rejilla de tiles de tile_size; el id 1 es la primera celda.
+void level_stream_draw_tiles(GLuint texture, int tex_w, int tex_h, int layer, float cam_x, float cam_y) {
+    if (!ls.open || layer < 0 || layer >= ls.info.layers || tex_w <= 0 || tex_h <= 0) return;
+
+    const int ts = ls.info.tile_size;
+    const int ct = ls.info.chunk_tiles;
+    const int cols = std::max(1, tex_w / ts);
+    const float du = (float)ts / tex_w, dv = (float)ts / tex_h;
+    const size_t per_layer = (size_t)ct * ct;
+
+    int x0, y0, x1, y1;
+    chunk_range(cam_x, cam_y, 0, x0, y0, x1, y1);
+
+    // Tiles visibles en coordenadas de mundo
+    int tx0 = (int)std::floor(cam_x / ts), ty0 = (int)std::floor(cam_y / ts);
+    int tx1 = (int)std::floor((cam_x + INTERNAL_W) / ts), ty1 = (int)std::floor((cam_y + INTERNAL_H) / ts);
+
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const LevelChunk* chunk = level_stream_chunk(cy * ls.info.chunks_x + cx);
+            if (!chunk || chunk->tiles.empty()) continue;
+            const Uint16* tiles = chunk->tiles.data() + layer * per_layer;
+
+            int base_x = cx * ct, base_y = cy * ct;
+            int lx0 = std::max(0, tx0 - base_x), ly0 = std::max(0, ty0 - base_y);
+            int lx1 = std::min(ct - 1, tx1 - base_x), ly1 = std::min(ct - 1, ty1 - base_y);
+
+            for (int ly = ly0; ly <= ly1; ++ly) {
+                for (int lx = lx0; lx <= lx1; ++lx) {
+                    Uint16 tile = tiles[ly * ct + lx];
+                    if (tile == 0) continue;
+                    float u0 = ((tile - 1) % cols) * du;
+                    float v0 = ((tile - 1) / cols) * dv;
+                    draw_sprite(texture, (float)((base_x + lx) * ts) - cam_x, (float)((base_y + ly) * ts) - cam_y,
+                                (float)ts, (float)ts, u0, v0, u0 + du, v0 + dv, 1, 1, 1, 1);
+                }
+            }
+        }
+    }
+}
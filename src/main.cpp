@@ -11,46 +11,11 @@
 #include "engine.hpp"          // engine.hpp debe definir GL_GLEXT_PROTOTYPES
 #include <SDL2/SDL_image.h>    // Carga de PNG
 #include <iostream>
+#include <algorithm>
 
 // Instancia global del motor
 EngineState engine;
 
-// Declaraciones forward de los módulos Lua (bindings)
-// SIN extern "C" – se compilan como C++
-int luaopen_util(lua_State* L);
-int luaopen_input(lua_State* L);
-int luaopen_audio(lua_State* L);
-int luaopen_graphics(lua_State* L);   // <-- NUEVO: módulo de gráficos
-
-// --- POLYFILL luaL_requiref (LuaJIT / Lua 5.1) ---
-void luaL_requiref(lua_State *L, const char *modname, lua_CFunction openf, int glb) {
-    lua_pushcfunction(L, openf);
-    lua_pushstring(L, modname);
-    lua_call(L, 1, 1);                // openf(modname) → tabla del módulo
-
-    lua_getfield(L, LUA_REGISTRYINDEX, "_LOADED");
-    lua_pushvalue(L, -2);             // copia del módulo
-    lua_setfield(L, -2, modname);    // _LOADED[modname] = módulo
-    lua_pop(L, 1);                   // sacar _LOADED
-
-    if (glb) {
-        lua_pushvalue(L, -1);        // copia del módulo
-        lua_setglobal(L, modname);   // _G[modname] = módulo
-    }
-    // El módulo permanece en la cima de la pila (como en Lua 5.2+)
-}
-
-// --- Manejador de pánico Lua ---
-int l_panic(lua_State* L) {
-    const char* err = lua_tostring(L, -1);
-    std::cerr << "\n========================================\n";
-    std::cerr << "!!! LUA PANIC !!!\n";
-    std::cerr << "Error: " << (err ? err : "desconocido") << "\n";
-    std::cerr << "========================================\n";
-    engine.running = false;
-    return 0;
-}
-
 // --- Inicialización de subsistemas ---
 bool init_subsystems() {
     // 1. SDL2 (video, audio, gamecontroller)
@@ -88,18 +53,15 @@ bool init_subsystems() {
         return false;
     }
 
-    // 6. VSync
+    // 6. VSync por defecto (configure_frame_pacing() lo ajusta tras leer config.lua)
     SDL_GL_SetSwapInterval(1);
 
     // 7. Inicializar sistema de renderizado (batch, shaders, buffers)
     init_renderer();
+    init_debug_draw();
+    init_render_stats();
 
-    // 8. SDL_mixer (audio)
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
-        std::cerr << "[ERROR] Mixer Error: " << Mix_GetError() << std::endl;
-        // No detenemos el motor, solo se desactiva el audio
-    }
-    Mix_AllocateChannels(32);
+    // 8. SDL_mixer se abre tras cargar Lua: configure_audio() lee config.audio
 
     // 9. Gamepad (primer mando compatible)
     engine.controller = nullptr;
@@ -129,16 +91,8 @@ bool init_lua() {
     lua_pushcfunction(engine.L, l_panic);
     lua_setglobal(engine.L, "panic");
 
-    // Cargar módulos nativos con luaL_requiref (registro en _LOADED y global)
-    luaL_requiref(engine.L, "util",   luaopen_util,   1);
-    lua_pop(engine.L, 1);
-    luaL_requiref(engine.L, "input",  luaopen_input,  1);
-    lua_pop(engine.L, 1);
-    luaL_requiref(engine.L, "audio",  luaopen_audio,  1);
-    lua_pop(engine.L, 1);
-    // Módulo de gráficos (batch + texture)
-    luaL_requiref(engine.L, "graphics", luaopen_graphics, 1);
-    lua_pop(engine.L, 1);
+    // Cargar módulos nativos (registro en _LOADED y global)
+    open_engine_modules(engine.L);
 
     // Inicializar cachés de audio
     engine.current_music = nullptr;
@@ -147,14 +101,227 @@ bool init_lua() {
     return true;
 }
 
+// --- Configuración del motor (scripts/config.lua) ---
+// Deja config[section] en la pila, o nil si no hay config cargable.
+static void push_config_section(lua_State* L, const char* section) {
+    lua_getglobal(L, "require");
+    lua_pushstring(L, "scripts.config");
+    if (lua_pcall(L, 1, 1, 0) != LUA_OK) {
+        std::cerr << "[CONFIG] No se pudo cargar scripts.config: " << lua_tostring(L, -1) << std::endl;
+        lua_pop(L, 1);
+        lua_pushnil(L);
+        return;
+    }
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_pushnil(L);
+        return;
+    }
+    lua_getfield(L, -1, section);
+    lua_remove(L, -2);
+}
+
+// --- Ritmo de frames ---
+static double now_seconds() {
+    return (double)SDL_GetPerformanceCounter() / (double)SDL_GetPerformanceFrequency();
+}
+
+// Espera hasta 'target': duerme con SDL_Delay y hace spin solo el tramo final
+static void wait_until(double target) {
+    double remaining = target - now_seconds();
+    while (remaining > engine.pacing.spin_margin) {
+        SDL_Delay((Uint32)((remaining - engine.pacing.spin_margin) * 1000.0));
+        remaining = target - now_seconds();
+    }
+    while (now_seconds() < target) {
+        // spin
+    }
+}
+
+static double display_period() {
+    SDL_DisplayMode mode;
+    int display = SDL_GetWindowDisplayIndex(engine.window);
+    if (display >= 0 && SDL_GetCurrentDisplayMode(display, &mode) == 0 && mode.refresh_rate > 0) {
+        return 1.0 / (double)mode.refresh_rate;
+    }
+    return 1.0 / 60.0;
+}
+
+// Lee config.system (pacing, vsync, fps_limit, late_input) y aplica el intervalo de swap.
+// Si el driver rechaza el vsync pedido, caemos a modo capped en lugar de hacer busy-spin.
+void configure_frame_pacing() {
+    FramePacing& p = engine.pacing;
+    lua_State* L = engine.L;
+
+    push_config_section(L, "system");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "fps_limit");
+        if (lua_isnumber(L, -1)) p.fps_limit = (int)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, -1, "late_input");
+        p.late_latch = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+
+        // 'pacing' explícito tiene prioridad; si no, se deduce de vsync/fps_limit
+        lua_getfield(L, -1, "pacing");
+        lua_getfield(L, -2, "vsync");
+        const char* pacing = lua_tostring(L, -2);
+        if (pacing) {
+            std::string m = pacing;
+            if (m == "adaptive")      p.mode = PACING_ADAPTIVE;
+            else if (m == "uncapped") p.mode = PACING_UNCAPPED;
+            else if (m == "capped")   p.mode = PACING_CAPPED;
+            else                      p.mode = PACING_VSYNC;
+        } else if (lua_isstring(L, -1) && std::string(lua_tostring(L, -1)) == "adaptive") {
+            p.mode = PACING_ADAPTIVE;
+        } else if (lua_isboolean(L, -1) && !lua_toboolean(L, -1)) {
+            p.mode = (p.fps_limit > 0) ? PACING_CAPPED : PACING_UNCAPPED;
+        } else {
+            p.mode = PACING_VSYNC;
+        }
+        lua_pop(L, 2);
+    }
+    lua_pop(L, 1);
+
+    if (p.mode == PACING_ADAPTIVE && SDL_GL_SetSwapInterval(-1) != 0) {
+        std::cerr << "[PACING] Adaptive vsync no soportado, usando vsync" << std::endl;
+        p.mode = PACING_VSYNC;
+    }
+    if (p.mode == PACING_VSYNC && SDL_GL_SetSwapInterval(1) != 0) {
+        std::cerr << "[PACING] VSync no disponible, limitando por software" << std::endl;
+        p.mode = PACING_CAPPED;
+        if (p.fps_limit <= 0) p.fps_limit = (int)std::lround(1.0 / display_period());
+    }
+    if (p.mode == PACING_CAPPED || p.mode == PACING_UNCAPPED) {
+        SDL_GL_SetSwapInterval(0);
+    }
+    if (p.mode == PACING_CAPPED && p.fps_limit <= 0) p.mode = PACING_UNCAPPED;
+
+    p.period = (p.mode == PACING_CAPPED) ? 1.0 / (double)p.fps_limit : display_period();
+    p.work_estimate = 0.0;
+    p.next_deadline = 0.0;
+
+    std::cout << "[PACING] Modo " << pacing_mode_name(p.mode)
+              << " (" << (1.0 / p.period) << " Hz" << (p.late_latch ? ", late input" : "") << ")" << std::endl;
+}
+
+// Presupuestos de memoria desde config.memory (en MB, 0 = sin límite)
+void configure_memory_budgets() {
+    lua_State* L = engine.L;
+    push_config_section(L, "memory");
+    if (lua_istable(L, -1)) {
+        for (int i = 0; i < MEM_COUNT; ++i) {
+            lua_getfield(L, -1, mem_category_name((MemCategory)i));
+            if (lua_isnumber(L, -1)) {
+                mem_set_budget((MemCategory)i, (size_t)(lua_tonumber(L, -1) * 1024.0 * 1024.0));
+            }
+            lua_pop(L, 1);
+        }
+    }
+    lua_pop(L, 1);
+}
+
+// Debug draw activo si config.debug.enabled y config.debug.show_hitboxes
+void configure_debug_draw() {
+    lua_State* L = engine.L;
+    bool enabled = false;
+    push_config_section(L, "debug");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "enabled");
+        lua_getfield(L, -2, "show_hitboxes");
+        enabled = lua_toboolean(L, -2) && lua_toboolean(L, -1);
+        lua_pop(L, 2);
+    }
+    lua_pop(L, 1);
+    debug_draw_set_enabled(enabled);
+}
+
+// Abre el audio según config.audio (buffer, low_latency). Debe ir antes del script
+// de arranque para que _init pueda reproducir sonido.
+void configure_audio() {
+    lua_State* L = engine.L;
+    AudioConfig config;
+    push_config_section(L, "audio");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "low_latency");
+        config.low_latency = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+
+        struct { const char* key; int* value; } ints[] = {
+            {"frequency", &config.frequency},
+            {"buffer", &config.buffer},
+            {"max_buffer", &config.max_buffer},
+            {"channels", &config.channels},
+            {"underrun_limit", &config.underrun_limit},
+        };
+        for (auto& field : ints) {
+            lua_getfield(L, -1, field.key);
+            if (lua_isnumber(L, -1)) *field.value = (int)lua_tointeger(L, -1);
+            lua_pop(L, 1);
+        }
+    }
+    lua_pop(L, 1);
+
+    if (!audio_open(config)) {
+        // No detenemos el motor, solo se desactiva el audio
+        std::cerr << "[ERROR] Audio desactivado" << std::endl;
+    }
+}
+
+// Late latching: retrasa la lectura de input hasta justo antes del próximo present,
+// dejando margen para el trabajo estimado del frame.
+static void wait_for_input_latch() {
+    FramePacing& p = engine.pacing;
+    if (!p.late_latch || p.mode == PACING_UNCAPPED || p.last_present == 0.0) return;
+
+    double present = (p.mode == PACING_CAPPED) ? p.next_deadline : p.last_present + p.period;
+    // Margen de seguridad: perder un vblank cuesta un frame entero
+    double safety = std::max(0.0015, p.period * 0.1);
+    double latch = present - p.work_estimate - safety;
+    if (latch > now_seconds()) wait_until(latch);
+}
+
+// Modo capped: espera al deadline del frame (sleep + spin) y programa el siguiente
+static void wait_for_frame_deadline() {
+    FramePacing& p = engine.pacing;
+    if (p.mode != PACING_CAPPED) return;
+
+    double now = now_seconds();
+    if (p.next_deadline == 0.0 || now - p.next_deadline > p.period) {
+        // Primer frame o vamos muy tarde: re-sincronizar en lugar de acumular deuda
+        p.next_deadline = now;
+    } else {
+        wait_until(p.next_deadline);
+    }
+    p.next_deadline += p.period;
+}
+
+// Tras el present: actualiza estimación de trabajo (sube rápido, baja lento) y latencia
+static void record_frame_timing(double latch_time, double work_end) {
+    FramePacing& p = engine.pacing;
+    double work = work_end - latch_time;
+    if (work > p.work_estimate) p.work_estimate = work;
+    else p.work_estimate = p.work_estimate * 0.95 + work * 0.05;
+
+    p.last_present = now_seconds();
+    double latency = p.last_present - latch_time;
+    p.latch_to_present = (p.latch_to_present == 0.0) ? latency : p.latch_to_present * 0.9 + latency * 0.1;
+}
+
 // --- Bucle principal con timestep fijo (60 FPS lógicos) ---
 void run_loop() {
     SDL_Event e;
     engine.last_tick = SDL_GetPerformanceCounter();
     engine.accumulator = 0.0;
     double perf_freq = (double)SDL_GetPerformanceFrequency();
+    Uint32 last_report = SDL_GetTicks();
 
     while (engine.running) {
+        // Con late input dormimos aquí, antes de leer eventos y simular
+        wait_for_input_latch();
+        double latch_time = now_seconds();
+
         // Tiempo transcurrido
         Uint64 current_tick = SDL_GetPerformanceCounter();
         double frame_time = (double)(current_tick - engine.last_tick) / perf_freq;
@@ -165,6 +332,17 @@ void run_loop() {
 
         engine.accumulator += frame_time;
 
+        // Memoria: heap Lua + presupuestos (el batch está vacío entre frames)
+        mem_frame_update();
+        // Back-off del buffer de audio si hubo underruns
+        audio_update();
+        if (engine.profile && SDL_GetTicks() - last_report >= 1000) {
+            last_report = SDL_GetTicks();
+            std::cout << "[PROFILER] " << mem_report_line() << std::endl;
+            std::cout << "[PROFILER] " << render_report_line() << std::endl;
+            std::cout << "[PROFILER] " << audio_report_line() << std::endl;
+        }
+
         // Eventos SDL
         while (SDL_PollEvent(&e) != 0) {
             if (e.type == SDL_QUIT) engine.running = false;
@@ -172,6 +350,8 @@ void run_loop() {
 
         // --- Fase de actualización (60 Hz) ---
         while (engine.accumulator >= engine.MS_PER_UPDATE) {
+            // Instante nominal del tick: los SFX que dispare se colocan en su muestra
+            audio_set_tick_time(latch_time - (engine.accumulator - engine.MS_PER_UPDATE));
             lua_getglobal(engine.L, "_update");
             if (lua_isfunction(engine.L, -1)) {
                 lua_pushnumber(engine.L, engine.MS_PER_UPDATE);
@@ -185,11 +365,15 @@ void run_loop() {
             }
             engine.accumulator -= engine.MS_PER_UPDATE;
         }
+        audio_set_tick_time(0.0);   // Fuera de _update los SFX suenan "ya"
 
         // --- Fase de renderizado ---
         // alpha (interpolación) reservado para futuro
         // double alpha = engine.accumulator / engine.MS_PER_UPDATE;
 
+        render_stats_begin_frame();
+        render_pass_begin(RENDER_PASS_SCENE);
+
         glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
@@ -203,8 +387,19 @@ void run_loop() {
         } else {
             lua_pop(engine.L, 1);           // sacar valor que no es función
         }
+        text_frame_end();
+
+        // Primitivas de debug encima de todo lo que dejó el batch
+        flush_batch();
+        render_pass_begin(RENDER_PASS_DEBUG);
+        debug_draw_flush();
+        render_pass_end();
+        render_stats_end_frame();
 
+        double work_end = now_seconds();
+        wait_for_frame_deadline();
         SDL_GL_SwapWindow(engine.window);
+        record_frame_timing(latch_time, work_end);
     }
 }
 
@@ -212,17 +407,18 @@ void run_loop() {
 void cleanup() {
     if (engine.L) lua_close(engine.L);
 
-    // Audio cache
-    for (auto const& [path, chunk] : engine.sfx_cache) {
-        Mix_FreeChunk(chunk);
-    }
+    // Audio: cerrar el dispositivo antes de liberar lo que mezcla el callback
     if (engine.current_music) Mix_FreeMusic(engine.current_music);
-    Mix_CloseAudio();
+    audio_close();
+    audio_free_sfx();
 
     // Game controller
     if (engine.controller) SDL_GameControllerClose(engine.controller);
 
     // OpenGL y ventana
+    level_stream_close();
+    free_all_fonts();
+    free_all_textures();
     SDL_GL_DeleteContext(engine.gl_context);
     SDL_DestroyWindow(engine.window);
 
@@ -235,6 +431,7 @@ void cleanup() {
 int main(int argc, char* argv[]) {
     if (!init_subsystems()) return 1;
     if (!init_lua()) return 1;
+    configure_audio();
 
     // Script de arranque (por defecto o pasado por argumento)
     std::string boot_script = "scripts/main.lua";
@@ -257,6 +454,13 @@ int main(int argc, char* argv[]) {
         lua_pop(engine.L, 1);
     }
 
+    // Ritmo de frames según config.system, presupuestos según config.memory
+    configure_frame_pacing();
+    configure_memory_budgets();
+    configure_debug_draw();
+    const char* profile_env = getenv("XPP_PROFILE");
+    engine.profile = profile_env && profile_env[0] == '1';
+
     // ¡Arrancar el motor!
     engine.running = true;
     run_loop();
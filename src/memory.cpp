@@ -0,0 +1,104 @@
+/**
+ * src/memory.cpp
+ * Contabilidad de memoria del motor: bytes por categoría (VRAM estimada de
+ * texturas, SFX decodificados, música, heap Lua, buffers del batch), presupuestos
+ * configurables y desalojo LRU de cachés de assets cuando se superan.
+ */
+
+#include "engine.hpp"
+#include <sstream>
+#include <iomanip>
+
+struct MemoryState {
+    MemCategoryStats stats[MEM_COUNT];
+    MemEvictFn evictors[MEM_COUNT] = {nullptr};
+    Uint32 last_warning[MEM_COUNT] = {0};
+};
+
+static MemoryState mem;
+
+static const char* category_names[MEM_COUNT] = {
+    "texture", "sfx", "music", "lua", "batch", "level", "bodies"
+};
+
+const char* mem_category_name(MemCategory cat) {
+    return category_names[cat];
+}
+
+// Busca una categoría por nombre (para Lua/config); MEM_COUNT si no existe
+MemCategory mem_category_from_name(const char* name) {
+    for (int i = 0; i < MEM_COUNT; ++i) {
+        if (std::string(name) == category_names[i]) return (MemCategory)i;
+    }
+    return MEM_COUNT;
+}
+
+void mem_track(MemCategory cat, long long delta) {
+    MemCategoryStats& s = mem.stats[cat];
+    if (delta < 0 && (size_t)(-delta) > s.used) s.used = 0;
+    else s.used = (size_t)((long long)s.used + delta);
+    if (s.used > s.peak) s.peak = s.used;
+}
+
+void mem_set(MemCategory cat, size_t bytes) {
+    MemCategoryStats& s = mem.stats[cat];
+    s.used = bytes;
+    if (s.used > s.peak) s.peak = s.used;
+}
+
+void mem_set_budget(MemCategory cat, size_t bytes) {
+    mem.stats[cat].budget = bytes;
+}
+
+void mem_set_evictor(MemCategory cat, MemEvictFn fn) {
+    mem.evictors[cat] = fn;
+}
+
+const MemCategoryStats& mem_stats(MemCategory cat) {
+    return mem.stats[cat];
+}
+
+size_t mem_total() {
+    size_t total = 0;
+    for (int i = 0; i < MEM_COUNT; ++i) total += mem.stats[i].used;
+    return total;
+}
+
+// Una vez por frame: mide el heap Lua y hace cumplir los presupuestos
+void mem_frame_update() {
+    if (engine.L) {
+        size_t lua_bytes = (size_t)lua_gc(engine.L, LUA_GCCOUNT, 0) * 1024
+                         + (size_t)lua_gc(engine.L, LUA_GCCOUNTB, 0);
+        mem_set(MEM_LUA, lua_bytes);
+
+        // Lua no tiene assets que desalojar: adelantamos trabajo del GC
+        const MemCategoryStats& ls = mem.stats[MEM_LUA];
+        if (ls.budget && ls.used > ls.budget) lua_gc(engine.L, LUA_GCSTEP, 0);
+    }
+
+    Uint32 now = SDL_GetTicks();
+    for (int i = 0; i < MEM_COUNT; ++i) {
+        MemCategoryStats& s = mem.stats[i];
+        if (!s.budget || s.used <= s.budget) continue;
+
+        if (mem.evictors[i]) mem.evictors[i](s.used - s.budget);
+
+        // Si ni desalojando cabemos, avisar (como mucho una vez por segundo)
+        if (s.used > s.budget && now - mem.last_warning[i] > 1000) {
+            mem.last_warning[i] = now;
+            std::cerr << "[MEMORY] Presupuesto '" << category_names[i] << "' excedido: "
+                      << s.used / 1024 << " KB / " << s.budget / 1024 << " KB" << std::endl;
+        }
+    }
+}
+
+// Línea compacta para la salida del profiler
+std::string mem_report_line() {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << "mem";
+    for (int i = 0; i < MEM_COUNT; ++i) {
+        out << " " << category_names[i] << "=" << mem.stats[i].used / (1024.0 * 1024.0) << "MB";
+    }
+    out << " total=" << mem_total() / (1024.0 * 1024.0) << "MB";
+    return out.str();
+}
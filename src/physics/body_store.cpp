@@ -0,0 +1,296 @@
+/**
+ * src/physics/body_store.cpp
+ * Almacén de cuerpos físicos en estructura de arrays (SoA) de capacidad fija.
+ *
+ * Cada campo (x, y, vx, layer, on_floor...) es un array contiguo indexado por
+ * slot. Lua los ve sin copias a través de LuaJIT FFI (XppBodyStore, ver
+ * scripts/core/ffi_bindings.lua) y los pases nativos (move_and_slide, debug
+ * draw) los recorren directamente, sin lua_getfield por campo.
+ *
+ * Los handles llevan el slot en los 16 bits bajos y la generación en los altos:
+ * un handle de un cuerpo liberado deja de ser válido aunque el slot se reutilice.
+ */
+
+#include "../engine.hpp"
+#include <algorithm>
+#include <cstring>
+
+struct BodyStoreState {
+    bool initialized = false;
+    XppBodyStore view = {};          // Punteros exportados a FFI
+
+    std::vector<double> x, y, w, h, vx, vy, sub_x, sub_y;
+    std::vector<Uint32> layer, mask;
+    // unsigned char en lugar de vector<bool> (que no es contiguo); mismo tamaño que bool
+    std::vector<unsigned char> is_sensor, on_floor, on_ceiling, on_wall_left, on_wall_right, alive;
+    std::vector<Uint16> generation;
+    std::vector<Uint32> free_slots;
+};
+
+static BodyStoreState bs;
+
+static inline Uint32 slot_of(Uint32 handle) { return handle & 0xFFFF; }
+static inline Uint16 gen_of(Uint32 handle) { return (Uint16)(handle >> 16); }
+
+static void init_body_store() {
+    if (bs.initialized) return;
+    bs.initialized = true;
+
+    const size_t n = BODY_CAPACITY;
+    for (auto* v : {&bs.x, &bs.y, &bs.w, &bs.h, &bs.vx, &bs.vy, &bs.sub_x, &bs.sub_y}) v->assign(n, 0.0);
+    bs.layer.assign(n, 0);
+    bs.mask.assign(n, 0);
+    for (auto* v : {&bs.is_sensor, &bs.on_floor, &bs.on_ceiling, &bs.on_wall_left, &bs.on_wall_right, &bs.alive}) {
+        v->assign(n, 0);
+    }
+    bs.generation.assign(n, 1);      // Generación 0 reservada: el handle 0 nunca es válido
+    bs.free_slots.reserve(n);
+
+    static_assert(sizeof(bool) == sizeof(unsigned char), "FFI espera bool de 1 byte");
+    XppBodyStore& v = bs.view;
+    v.capacity = BODY_CAPACITY;
+    v.x = bs.x.data();          v.y = bs.y.data();
+    v.w = bs.w.data();          v.h = bs.h.data();
+    v.vx = bs.vx.data();        v.vy = bs.vy.data();
+    v.sub_x = bs.sub_x.data();  v.sub_y = bs.sub_y.data();
+    v.layer = bs.layer.data();  v.mask = bs.mask.data();
+    v.is_sensor = (bool*)bs.is_sensor.data();
+    v.on_floor = (bool*)bs.on_floor.data();
+    v.on_ceiling = (bool*)bs.on_ceiling.data();
+    v.on_wall_left = (bool*)bs.on_wall_left.data();
+    v.on_wall_right = (bool*)bs.on_wall_right.data();
+    v.alive = (bool*)bs.alive.data();
+    v.generation = bs.generation.data();
+
+    // 8 doubles + 2 u32 + 6 flags + generación por slot
+    mem_set(MEM_BODIES, n * (8 * sizeof(double) + 2 * sizeof(Uint32) + 6 + sizeof(Uint16)));
+}
+
+bool body_valid(Uint32 handle) {
+    Uint32 slot = slot_of(handle);
+    return bs.initialized && slot < bs.view.used && bs.alive[slot] && bs.generation[slot] == gen_of(handle);
+}
+
+extern "C" XppBodyStore* xpp_body_store(void) {
+    init_body_store();
+    return &bs.view;
+}
+
+// Nuevo cuerpo con todos los campos a 0 -> handle (0 si el almacén está lleno)
+extern "C" Uint32 xpp_body_alloc(void) {
+    init_body_store();
+
+    Uint32 slot;
+    if (!bs.free_slots.empty()) {
+        slot = bs.free_slots.back();
+        bs.free_slots.pop_back();
+    } else if (bs.view.used < BODY_CAPACITY) {
+        slot = bs.view.used++;
+    } else {
+        return 0;
+    }
+
+    bs.x[slot] = bs.y[slot] = bs.w[slot] = bs.h[slot] = 0.0;
+    bs.vx[slot] = bs.vy[slot] = bs.sub_x[slot] = bs.sub_y[slot] = 0.0;
+    bs.layer[slot] = bs.mask[slot] = 0;
+    bs.is_sensor[slot] = bs.on_floor[slot] = bs.on_ceiling[slot] = 0;
+    bs.on_wall_left[slot] = bs.on_wall_right[slot] = 0;
+    bs.alive[slot] = 1;
+    bs.view.live++;
+    return ((Uint32)bs.generation[slot] << 16) | slot;
+}
+
+// Libera el slot (finalizador ffi.gc del proxy). Handles caducados se ignoran.
+extern "C" void xpp_body_free(Uint32 handle) {
+    if (!body_valid(handle)) return;
+    Uint32 slot = slot_of(handle);
+    bs.alive[slot] = 0;
+    if (++bs.generation[slot] == 0) bs.generation[slot] = 1;
+    bs.free_slots.push_back(slot);
+    bs.view.live--;
+}
+
+extern "C" int xpp_body_valid(Uint32 handle) {
+    return body_valid(handle) ? 1 : 0;
+}
+
+// Parte entera del desplazamiento con acumulador de sub-píxel (igual que
+// Body:integrate_velocity en physics.lua)
+static double integrate_axis(double v, double& sub) {
+    double whole = std::floor(v);
+    sub += v - whole;
+    if (sub >= 1.0) {
+        sub -= 1.0;
+        whole += 1.0;
+    } else if (sub <= -1.0) {
+        sub += 1.0;
+        whole -= 1.0;
+    }
+    return whole;
+}
+
+static CollideRect rect_of(Uint32 slot) {
+    return CollideRect{(float)bs.x[slot], (float)bs.y[slot], (float)bs.w[slot], (float)bs.h[slot]};
+}
+
+// move_and_slide nativo contra el conjunto estático de collide (sincronizado
+// desde Lua con la lista de sólidos antes de llamar). Mismo orden que la
+// versión Lua: eje X y luego eje Y, cada uno con un barrido.
+extern "C" void xpp_body_move_and_slide(Uint32 handle) {
+    if (!body_valid(handle)) return;
+    Uint32 i = slot_of(handle);
+
+    double dx = integrate_axis(bs.vx[i], bs.sub_x[i]);
+    double dy = integrate_axis(bs.vy[i], bs.sub_y[i]);
+
+    bs.on_floor[i] = bs.on_ceiling[i] = 0;
+    bs.on_wall_left[i] = bs.on_wall_right[i] = 0;
+    bool solid_body = !bs.is_sensor[i];
+
+    SweepHit hit;
+    if (dx != 0.0 && solid_body && collide_sweep(rect_of(i), (float)dx, 0.0f, false, &hit)) {
+        const CollideRect& s = collide_solid(hit.index);
+        if (dx > 0.0) {
+            bs.x[i] = s.x - bs.w[i];
+            bs.on_wall_right[i] = 1;
+        } else {
+            bs.x[i] = s.x + s.w;
+            bs.on_wall_left[i] = 1;
+        }
+        bs.vx[i] = 0.0;
+    } else {
+        bs.x[i] += dx;
+    }
+
+    if (dy != 0.0 && solid_body && collide_sweep(rect_of(i), 0.0f, (float)dy, false, &hit)) {
+        const CollideRect& s = collide_solid(hit.index);
+        if (dy > 0.0) {
+            bs.y[i] = s.y - bs.h[i];
+            bs.on_floor[i] = 1;
+        } else {
+            bs.y[i] = s.y + s.h;
+            bs.on_ceiling[i] = 1;
+        }
+        bs.vy[i] = 0.0;
+    } else {
+        bs.y[i] += dy;
+    }
+}
+
+// Pase de debug: AABB de todos los cuerpos vivos dentro de la vista (cámara cx, cy),
+// coloreados por capa, con las aristas de contacto en rojo y el vector velocidad.
+extern "C" void xpp_bodies_debug_draw(float cx, float cy) {
+    if (!bs.initialized || !debug_draw_enabled()) return;
+
+    struct LayerColor { Uint32 layer; float r, g, b; };
+    static const LayerColor colors[] = {
+        {1, 0.2f, 0.9f, 0.2f},    // WORLD
+        {2, 0.2f, 0.8f, 1.0f},    // PLAYER
+        {4, 1.0f, 0.25f, 0.25f},  // ENEMY
+        {8, 1.0f, 1.0f, 0.3f},    // PLAYER_SHOT
+        {16, 1.0f, 0.6f, 0.1f},   // ENEMY_SHOT
+        {32, 1.0f, 0.3f, 1.0f},   // ITEM
+        {64, 0.4f, 0.4f, 1.0f},   // TRIGGER
+    };
+
+    for (Uint32 i = 0; i < bs.view.used; ++i) {
+        if (!bs.alive[i]) continue;
+        float x = (float)bs.x[i] - cx, y = (float)bs.y[i] - cy;
+        float w = (float)bs.w[i], h = (float)bs.h[i];
+        // Culling: fuera de la pantalla no genera primitivas
+        if (x + w < 0.0f || y + h < 0.0f || x > INTERNAL_W || y > INTERNAL_H) continue;
+
+        float r = 1.0f, g = 1.0f, b = 1.0f;
+        for (const LayerColor& c : colors) {
+            if (c.layer == bs.layer[i]) { r = c.r; g = c.g; b = c.b; break; }
+        }
+        debug_draw_outline(x, y, w, h, r, g, b, bs.is_sensor[i] ? 0.5f : 1.0f);
+
+        if (bs.on_floor[i]) debug_draw_line(x, y + h, x + w, y + h, 1, 0, 0, 1);
+        if (bs.on_ceiling[i]) debug_draw_line(x, y, x + w, y, 1, 0, 0, 1);
+        if (bs.on_wall_left[i]) debug_draw_line(x, y, x, y + h, 1, 0, 0, 1);
+        if (bs.on_wall_right[i]) debug_draw_line(x + w, y, x + w, y + h, 1, 0, 0, 1);
+
+        if (bs.vx[i] != 0.0 || bs.vy[i] != 0.0) {
+            float mx = x + w / 2, my = y + h / 2;
+            debug_draw_cross(mx, my, 3, 1, 1, 1, 1);
+            debug_draw_line(mx, my, mx + (float)bs.vx[i] * 8, my + (float)bs.vy[i] * 8, 1, 1, 1, 0.8f);
+        }
+    }
+}
+
+// ============================================================================
+// SNAPSHOTS
+// ============================================================================
+// Se guardan los arrays completos hasta 'used'. Al restaurar solo se copian los
+// slots que siguen siendo el mismo cuerpo (vivo, misma generación): mientras un
+// snapshot siga en el anillo, sus anclas mantienen vivos los proxies que
+// referencia, así que recuperan su estado. Al salir del anillo el último snapshot
+// que los usa, el GC puede liberarlos. Los slots creados o liberados después no
+// se tocan.
+
+template <typename T>
+static void save_array(std::vector<uint8_t>& out, const std::vector<T>& v, Uint32 used) {
+    const uint8_t* p = (const uint8_t*)v.data();
+    out.insert(out.end(), p, p + used * sizeof(T));
+}
+
+void body_store_save(std::vector<uint8_t>& out) {
+    Uint32 used = bs.initialized ? bs.view.used : 0;
+    const uint8_t* p = (const uint8_t*)&used;
+    out.insert(out.end(), p, p + sizeof(used));
+    if (!used) return;
+
+    save_array(out, bs.generation, used);
+    save_array(out, bs.alive, used);
+    for (auto* v : {&bs.x, &bs.y, &bs.w, &bs.h, &bs.vx, &bs.vy, &bs.sub_x, &bs.sub_y}) save_array(out, *v, used);
+    save_array(out, bs.layer, used);
+    save_array(out, bs.mask, used);
+    for (auto* v : {&bs.is_sensor, &bs.on_floor, &bs.on_ceiling, &bs.on_wall_left, &bs.on_wall_right}) {
+        save_array(out, *v, used);
+    }
+}
+
+// Tamaño de los datos guardados de 'used' slots (tras el contador)
+static size_t saved_size(Uint32 used) {
+    return used * (sizeof(Uint16) + 1 + 8 * sizeof(double) + 2 * sizeof(Uint32) + 5);
+}
+
+template <typename T>
+static void restore_array(const uint8_t*& p, std::vector<T>& v, Uint32 used, const std::vector<bool>& same) {
+    for (Uint32 i = 0; i < used; ++i) {
+        if (same[i]) memcpy(&v[i], p + i * sizeof(T), sizeof(T));
+    }
+    p += used * sizeof(T);
+}
+
+bool body_store_load(const uint8_t*& p, const uint8_t* end) {
+    Uint32 used = 0;
+    if ((size_t)(end - p) < sizeof(used)) return false;
+    memcpy(&used, p, sizeof(used));
+    p += sizeof(used);
+    if (!used) return true;
+    if (used > BODY_CAPACITY || (size_t)(end - p) < saved_size(used)) return false;
+
+    init_body_store();
+    Uint32 live_used = std::min(used, bs.view.used);
+
+    // ¿Qué slots siguen siendo el mismo cuerpo?
+    const uint8_t* gen = p;
+    const uint8_t* alive = p + used * sizeof(Uint16);
+    std::vector<bool> same(used, false);
+    for (Uint32 i = 0; i < live_used; ++i) {
+        Uint16 g;
+        memcpy(&g, gen + i * sizeof(Uint16), sizeof(g));
+        same[i] = alive[i] && bs.alive[i] && g == bs.generation[i];
+    }
+    p = alive + used;
+
+    for (auto* v : {&bs.x, &bs.y, &bs.w, &bs.h, &bs.vx, &bs.vy, &bs.sub_x, &bs.sub_y}) restore_array(p, *v, used, same);
+    restore_array(p, bs.layer, used, same);
+    restore_array(p, bs.mask, used, same);
+    for (auto* v : {&bs.is_sensor, &bs.on_floor, &bs.on_ceiling, &bs.on_wall_left, &bs.on_wall_right}) {
+        restore_array(p, *v, used, same);
+    }
+    return true;
+}
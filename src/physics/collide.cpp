@@ -0,0 +1,173 @@
+/**
+ * src/physics/collide.cpp
+ * Colisión continua: barrido de AABB (swept AABB) con tiempo de impacto y normal
+ * de contacto. move_and_slide y los proyectiles barren su desplazamiento entero
+ * en lugar de moverse y luego comprobar solapes, así que un cuerpo rápido no
+ * atraviesa plataformas más finas que su velocidad.
+ *
+ * Los sólidos estáticos (_G.map_solids) se copian aquí con collide_set_solids()
+ * y se indexan en una rejilla uniforme; physics.lua la resincroniza sola cuando
+ * cambia la lista.
+ */
+
+#include "../engine.hpp"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+static const float COLLIDE_CELL = 64.0f;
+// Sólidos que ocupan más celdas que esto se prueban siempre (no se indexan)
+static const long long MAX_CELLS_PER_SOLID = 256;
+
+struct CollideState {
+    std::vector<CollideRect> solids;
+    std::unordered_map<long long, std::vector<int>> grid;   // celda -> índices
+    std::vector<int> oversized;
+    std::vector<Uint32> stamp;   // Última consulta que visitó cada sólido
+    Uint32 query = 0;
+    CollideStats stats;
+};
+
+static CollideState cs;
+
+static long long cell_key(int cx, int cy) {
+    return ((long long)cx << 32) ^ (long long)(Uint32)cy;
+}
+
+static int cell_of(float v) {
+    return (int)std::floor(v / COLLIDE_CELL);
+}
+
+void collide_set_solids(std::vector<CollideRect>&& solids) {
+    cs.solids = std::move(solids);
+    cs.grid.clear();
+    cs.oversized.clear();
+    cs.stamp.assign(cs.solids.size(), 0);
+    cs.query = 0;
+
+    for (int i = 0; i < (int)cs.solids.size(); ++i) {
+        const CollideRect& r = cs.solids[i];
+        int x0 = cell_of(r.x), x1 = cell_of(r.x + r.w);
+        int y0 = cell_of(r.y), y1 = cell_of(r.y + r.h);
+        if ((long long)(x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CELLS_PER_SOLID) {
+            cs.oversized.push_back(i);
+            continue;
+        }
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) cs.grid[cell_key(cx, cy)].push_back(i);
+        }
+    }
+    cs.stats.solids = cs.solids.size();
+    cs.stats.resyncs++;
+}
+
+// Tiempo de entrada/salida de un eje (método de slabs).
+// false si el eje nunca se solapa durante el movimiento.
+static bool axis_times(float a, float aw, float d, float b, float bw, float* entry, float* exit) {
+    const float inf = std::numeric_limits<float>::infinity();
+    if (d > 0.0f) {
+        *entry = (b - (a + aw)) / d;
+        *exit = (b + bw - a) / d;
+    } else if (d < 0.0f) {
+        *entry = (b + bw - a) / d;
+        *exit = (b - (a + aw)) / d;
+    } else {
+        // Sin movimiento en este eje: o se solapa siempre o nunca
+        if (a < b + bw && a + aw > b) {
+            *entry = -inf;
+            *exit = inf;
+            return true;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool sweep_aabb(const CollideRect& a, float dx, float dy, const CollideRect& b,
+                bool hit_overlap, SweepHit* hit) {
+    // Ya solapados al empezar: o contacto inmediato o se ignora (deja salir al cuerpo)
+    if (a.x < b.x + b.w && a.x + a.w > b.x && a.y < b.y + b.h && a.y + a.h > b.y) {
+        if (!hit_overlap) return false;
+        hit->t = 0.0f;
+        hit->nx = hit->ny = 0.0f;
+        return true;
+    }
+
+    float x_entry, x_exit, y_entry, y_exit;
+    if (!axis_times(a.x, a.w, dx, b.x, b.w, &x_entry, &x_exit)) return false;
+    if (!axis_times(a.y, a.h, dy, b.y, b.h, &y_entry, &y_exit)) return false;
+
+    float entry = std::max(x_entry, y_entry);
+    float exit = std::min(x_exit, y_exit);
+    // entry == exit: roce de esquina o de borde, sin área de contacto
+    if (entry >= exit || entry < 0.0f || entry >= 1.0f) return false;
+
+    hit->t = entry;
+    if (x_entry > y_entry) {
+        hit->nx = dx > 0.0f ? -1.0f : 1.0f;
+        hit->ny = 0.0f;
+    } else {
+        hit->nx = 0.0f;
+        hit->ny = dy > 0.0f ? -1.0f : 1.0f;
+    }
+    return true;
+}
+
+static void test_solid(int i, const CollideRect& box, float dx, float dy, bool hit_overlap, SweepHit* best) {
+    if (cs.stamp[i] == cs.query) return;
+    cs.stamp[i] = cs.query;
+    cs.stats.candidates++;
+
+    SweepHit hit;
+    if (!sweep_aabb(box, dx, dy, cs.solids[i], hit_overlap, &hit)) return;
+    // Empates: gana el primero de la lista (resultado estable)
+    if (best->index < 0 || hit.t < best->t || (hit.t == best->t && i < best->index)) {
+        hit.index = i;
+        *best = hit;
+    }
+}
+
+bool collide_sweep(const CollideRect& box, float dx, float dy, bool hit_overlap, SweepHit* out) {
+    cs.stats.sweeps++;
+    SweepHit best;
+    if (cs.solids.empty()) {
+        *out = best;
+        return false;
+    }
+    if (++cs.query == 0) {
+        // Desbordamiento del contador: reiniciar marcas
+        std::fill(cs.stamp.begin(), cs.stamp.end(), 0);
+        cs.query = 1;
+    }
+
+    // Región barrida
+    float x0 = std::min(box.x, box.x + dx), x1 = std::max(box.x + box.w, box.x + box.w + dx);
+    float y0 = std::min(box.y, box.y + dy), y1 = std::max(box.y + box.h, box.y + box.h + dy);
+    int cx0 = cell_of(x0), cx1 = cell_of(x1);
+    int cy0 = cell_of(y0), cy1 = cell_of(y1);
+
+    if ((long long)(cx1 - cx0 + 1) * (cy1 - cy0 + 1) > (long long)cs.solids.size()) {
+        // Barrido enorme (teletransporte): más barato probar todo
+        for (int i = 0; i < (int)cs.solids.size(); ++i) test_solid(i, box, dx, dy, hit_overlap, &best);
+    } else {
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                auto it = cs.grid.find(cell_key(cx, cy));
+                if (it == cs.grid.end()) continue;
+                for (int i : it->second) test_solid(i, box, dx, dy, hit_overlap, &best);
+            }
+        }
+        for (int i : cs.oversized) test_solid(i, box, dx, dy, hit_overlap, &best);
+    }
+
+    *out = best;
+    return best.index >= 0;
+}
+
+const CollideRect& collide_solid(int index) {
+    return cs.solids[index];
+}
+
+const CollideStats& collide_stats() {
+    return cs.stats;
+}
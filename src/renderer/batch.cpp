@@ -6,13 +6,24 @@ struct Vertex {
     float x, y;       // Posición
     float u, v;       // UVs
     float r, g, b, a; // Color
+    float palette;    // Fila del atlas de paletas (-1 = textura RGBA)
 };
 
 // Estado interno del Batch Renderer
 struct BatchState {
     GLuint VAO, VBO;
     GLuint shaderProgram;
+    GLint projLoc = -1;
     std::vector<Vertex> vertices;
+
+    // Textura de los vértices pendientes (cambiarla fuerza un flush)
+    GLuint texture = 0;
+    int texture_palette = -1;   // Paleta propia de 'texture' si es indexada
+
+    // Última cámara subida al shader (evita re-subir la misma matriz)
+    float cam_x = 0.0f, cam_y = 0.0f;
+    bool camera_valid = false;
+
     // Capacidad máxima por draw call (1000 sprites * 6 vértices)
     const size_t MAX_SPRITES = 1000;
 };
@@ -24,22 +35,32 @@ const char* vertexShaderSource = "#version 330 core\n"
 "layout (location = 0) in vec2 aPos;\n"
 "layout (location = 1) in vec2 aTexCoord;\n"
 "layout (location = 2) in vec4 aColor;\n"
+"layout (location = 3) in float aPalette;\n"
 "out vec2 TexCoord;\n"
 "out vec4 Color;\n"
+"flat out float Palette;\n"
 "uniform mat4 projection;\n"
 "void main() {\n"
 "   gl_Position = projection * vec4(aPos, 0.0, 1.0);\n"
 "   TexCoord = aTexCoord;\n"
 "   Color = aColor;\n"
+"   Palette = aPalette;\n"
 "}\0";
 
 const char* fragmentShaderSource = "#version 330 core\n"
 "in vec2 TexCoord;\n"
 "in vec4 Color;\n"
+"flat in float Palette;\n"
 "out vec4 FragColor;\n"
 "uniform sampler2D image;\n"
+"uniform sampler2D palettes;\n"
 "void main() {\n"
-"   FragColor = texture(image, TexCoord) * Color;\n"
+"   vec4 texel = texture(image, TexCoord);\n"
+"   if (Palette >= 0.0) {\n"
+"       int index = int(texel.r * 255.0 + 0.5);\n"
+"       texel = texelFetch(palettes, ivec2(index, int(Palette)), 0);\n"
+"   }\n"
+"   FragColor = texel * Color;\n"
 "}\0";
 
 // Función auxiliar para compilar shaders
@@ -85,13 +106,16 @@ void init_renderer() {
     glGenVertexArrays(1, &batch.VAO);
     glGenBuffers(1, &batch.VBO);
 
-    glBindVertexArray(batch.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, batch.VBO);
+    gl_bind_vertex_array(batch.VAO);
+    gl_bind_array_buffer(batch.VBO);
 
     // Reservar memoria (Buffer huérfano dinámico)
     glBufferData(GL_ARRAY_BUFFER, batch.MAX_SPRITES * 6 * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    batch.vertices.reserve(batch.MAX_SPRITES * 6);
+    // Copia en CPU + VBO del mismo tamaño
+    mem_set(MEM_BATCH, batch.vertices.capacity() * sizeof(Vertex) * 2);
 
-    // Atributos: Pos(2) + UV(2) + Color(4) = 8 floats stride
+    // Atributos: Pos(2) + UV(2) + Color(4) + Paleta(1) = 9 floats stride
     // 0: Pos
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
     glEnableVertexAttribArray(0);
@@ -101,41 +125,45 @@ void init_renderer() {
     // 2: Color
     glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(4 * sizeof(float)));
     glEnableVertexAttribArray(2);
+    // 3: Paleta
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(8 * sizeof(float)));
+    glEnableVertexAttribArray(3);
 
-    // 3. Configurar Matriz de Proyección (Ortho)
-    glUseProgram(batch.shaderProgram);
+    // 3. Uniforms: ubicaciones resueltas una sola vez (caché de estado GL)
+    gl_use_program(batch.shaderProgram);
+    batch.projLoc = gl_uniform_location(batch.shaderProgram, "projection");
+    glUniform1i(gl_uniform_location(batch.shaderProgram, "image"), 0);
+    glUniform1i(gl_uniform_location(batch.shaderProgram, "palettes"), 1);
 
-    // Matriz Ortográfica Manual (0,0 top-left -> INTERNAL_W, INTERNAL_H bottom-right)
-    float l = 0, r = (float)INTERNAL_W;
-    float b = (float)INTERNAL_H, t = 0; // Invertido Y para coordenadas de pantalla
-
-    float ortho[16] = {
-        2.0f/(r-l),   0,            0, 0,
-        0,            2.0f/(t-b),   0, 0,
-        0,            0,           -1, 0,
-        -(r+l)/(r-l), -(t+b)/(t-b), 0, 1
-    };
+    init_palettes();
 
-    GLint projLoc = glGetUniformLocation(batch.shaderProgram, "projection");
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, ortho);
+    // Matriz Ortográfica inicial (0,0 top-left -> INTERNAL_W, INTERNAL_H bottom-right)
+    set_camera(0.0f, 0.0f);
 }
 
+static void flush_batch_for(FlushReason reason);
+
 // Enviar geometría a la GPU
 
 void draw_sprite(GLuint texture, float x, float y, float w, float h,
                  float u0, float v0, float u1, float v1,
-                 float r, float g, float b, float a)
+                 float r, float g, float b, float a, int palette)
 {
-    // Si el batch está lleno o cambiamos de textura (opcional), podríamos hacer flush automático.
-    // Por simplicidad en este paso, asumimos una sola textura atlas o que Lua gestiona los cambios.
-    // NOTA: Para un motor real, deberíamos chequear si 'texture' cambia y hacer flush.
+    // Cambio de textura: dibujamos lo pendiente con la textura anterior
+    if (texture != batch.texture) {
+        flush_batch_for(FLUSH_TEXTURE);
+        batch.texture = texture;
+        batch.texture_palette = touch_texture(texture);
+    }
+    // Sin paleta explícita: la de la textura (las RGBA no tienen y se muestrean tal cual)
+    float p = (float)(palette >= 0 ? palette : batch.texture_palette);
 
     // Si superamos la capacidad, dibujamos lo que hay y limpiamos
     if (batch.vertices.size() + 6 > batch.MAX_SPRITES * 6) {
-        flush_batch();
+        flush_batch_for(FLUSH_FULL);
     }
 
-    // Definir los 4 vértices del quad (x, y, u, v, r, g, b, a)
+    // Definir los 4 vértices del quad (x, y, u, v, r, g, b, a, paleta)
     // Orden: Top-Left, Bottom-Left, Bottom-Right, Top-Left, Bottom-Right, Top-Right (2 triángulos)
 
     // Vértices
@@ -145,36 +173,62 @@ void draw_sprite(GLuint texture, float x, float y, float w, float h,
     float y2 = y + h;
 
     // Triángulo 1
-    batch.vertices.push_back({x1, y1, u0, v0, r, g, b, a}); // TL
-    batch.vertices.push_back({x1, y2, u0, v1, r, g, b, a}); // BL
-    batch.vertices.push_back({x2, y2, u1, v1, r, g, b, a}); // BR
+    batch.vertices.push_back({x1, y1, u0, v0, r, g, b, a, p}); // TL
+    batch.vertices.push_back({x1, y2, u0, v1, r, g, b, a, p}); // BL
+    batch.vertices.push_back({x2, y2, u1, v1, r, g, b, a, p}); // BR
 
     // Triángulo 2
-    batch.vertices.push_back({x1, y1, u0, v0, r, g, b, a}); // TL
-    batch.vertices.push_back({x2, y2, u1, v1, r, g, b, a}); // BR
-    batch.vertices.push_back({x2, y1, u1, v0, r, g, b, a}); // TR
+    batch.vertices.push_back({x1, y1, u0, v0, r, g, b, a, p}); // TL
+    batch.vertices.push_back({x2, y2, u1, v1, r, g, b, a, p}); // BR
+    batch.vertices.push_back({x2, y1, u1, v0, r, g, b, a, p}); // TR
 }
 
-void flush_batch() {
+static void flush_batch_for(FlushReason reason) {
     if (batch.vertices.empty()) return;
 
-    glBindBuffer(GL_ARRAY_BUFFER, batch.VBO);
+    // Los binds pasan por la caché: si nada cambió desde el último flush no se emiten
+    gl_bind_array_buffer(batch.VBO);
     // Subir datos
-    glBufferSubData(GL_ARRAY_BUFFER, 0, batch.vertices.size() * sizeof(Vertex), batch.vertices.data());
+    size_t bytes = batch.vertices.size() * sizeof(Vertex);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, batch.vertices.data());
 
-    glUseProgram(batch.shaderProgram);
-    glBindVertexArray(batch.VAO);
+    gl_use_program(batch.shaderProgram);
+    gl_bind_vertex_array(batch.VAO);
+    gl_bind_texture(0, batch.texture);
+    palette_upload();
+    gl_bind_texture(1, palette_texture());
 
     // Dibujar
     glDrawArrays(GL_TRIANGLES, 0, batch.vertices.size());
+    render_stats_flush(reason);
+    render_stats_draw((Uint32)batch.vertices.size(), bytes);
 
     // Limpiar para el siguiente frame
     batch.vertices.clear();
 }
 
+void flush_batch() {
+    flush_batch_for(FLUSH_EXPLICIT);
+}
+
+// Una textura borrada puede reciclar su ID en GL: olvidarla obliga a volver a
+// consultar su paleta en el siguiente draw_sprite
+void batch_forget_texture(GLuint texture) {
+    if (batch.texture != texture) return;
+    flush_batch_for(FLUSH_TEXTURE);
+    batch.texture = 0;
+    batch.texture_palette = -1;
+}
+
 void set_camera(float x, float y) {
+    // Misma cámara que la última vez: la matriz del shader ya es correcta
+    if (batch.camera_valid && batch.cam_x == x && batch.cam_y == y) return;
+
+    // Lo pendiente se dibujó con la cámara anterior
+    flush_batch_for(FLUSH_CAMERA);
+
     // Aseguramos que el shader esté activo
-    glUseProgram(batch.shaderProgram);
+    gl_use_program(batch.shaderProgram);
 
     // Recalcular Matriz Ortográfica
     // La cámara mueve el "mundo", así que los límites de proyección cambian.
@@ -192,6 +246,15 @@ void set_camera(float x, float y) {
         -(r+l)/(r-l), -(t+b)/(t-b), 0, 1
     };
 
-    GLint projLoc = glGetUniformLocation(batch.shaderProgram, "projection");
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, ortho);
+    glUniformMatrix4fv(batch.projLoc, 1, GL_FALSE, ortho);
+
+    batch.cam_x = x;
+    batch.cam_y = y;
+    batch.camera_valid = true;
+}
+
+// Cámara actual (el debug draw la usa para pasar primitivas a coordenadas de pantalla)
+void get_camera(float* x, float* y) {
+    if (x) *x = batch.cam_x;
+    if (y) *y = batch.cam_y;
 }
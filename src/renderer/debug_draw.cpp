@@ -0,0 +1,202 @@
+/**
+ * src/renderer/debug_draw.cpp
+ * Primitivas de depuración (rectángulos, contornos, líneas, cruces) sin textura.
+ * Shader y buffer propios: no rompen el batching de sprites ni cambian su textura.
+ * Todo se triangula (las líneas son quads de 1px internos) y sale en un solo
+ * draw call después del batch principal.
+ */
+
+#include "../engine.hpp"
+#include <algorithm>
+
+#if XPP_DEBUG_DRAW
+
+// compileShader vive en batch.cpp
+GLuint compileShader(GLenum type, const char* source);
+
+struct DebugVertex {
+    float x, y;       // Posición en pantalla interna (cámara ya aplicada)
+    float r, g, b, a; // Color
+};
+
+struct DebugDrawState {
+    GLuint VAO = 0, VBO = 0;
+    GLuint shaderProgram = 0;
+    size_t vbo_capacity = 0;   // En vértices
+    std::vector<DebugVertex> vertices;
+    bool enabled = false;
+
+    Uint32 primitives = 0;     // Frame en curso
+    DebugDrawStats stats;      // Último frame dibujado
+};
+
+static DebugDrawState dbg;
+
+static const char* debugVertexSource = "#version 330 core\n"
+"layout (location = 0) in vec2 aPos;\n"
+"layout (location = 1) in vec4 aColor;\n"
+"out vec4 Color;\n"
+"uniform mat4 projection;\n"
+"void main() {\n"
+"   gl_Position = projection * vec4(aPos, 0.0, 1.0);\n"
+"   Color = aColor;\n"
+"}\0";
+
+static const char* debugFragmentSource = "#version 330 core\n"
+"in vec4 Color;\n"
+"out vec4 FragColor;\n"
+"void main() {\n"
+"   FragColor = Color;\n"
+"}\0";
+
+void init_debug_draw() {
+    GLuint vertex = compileShader(GL_VERTEX_SHADER, debugVertexSource);
+    GLuint fragment = compileShader(GL_FRAGMENT_SHADER, debugFragmentSource);
+
+    dbg.shaderProgram = glCreateProgram();
+    glAttachShader(dbg.shaderProgram, vertex);
+    glAttachShader(dbg.shaderProgram, fragment);
+    glLinkProgram(dbg.shaderProgram);
+
+    int success;
+    char infoLog[512];
+    glGetProgramiv(dbg.shaderProgram, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(dbg.shaderProgram, 512, NULL, infoLog);
+        std::cerr << "[DEBUG DRAW] " << infoLog << std::endl;
+    }
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    glGenVertexArrays(1, &dbg.VAO);
+    glGenBuffers(1, &dbg.VBO);
+    gl_bind_vertex_array(dbg.VAO);
+    gl_bind_array_buffer(dbg.VBO);
+
+    // Atributos: Pos(2) + Color(4)
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // Proyección fija a pantalla interna: la cámara se aplica al encolar
+    float l = 0, r = (float)INTERNAL_W, b = (float)INTERNAL_H, t = 0;
+    float ortho[16] = {
+        2.0f/(r-l),   0,            0, 0,
+        0,            2.0f/(t-b),   0, 0,
+        0,            0,           -1, 0,
+        -(r+l)/(r-l), -(t+b)/(t-b), 0, 1
+    };
+    gl_use_program(dbg.shaderProgram);
+    glUniformMatrix4fv(gl_uniform_location(dbg.shaderProgram, "projection"), 1, GL_FALSE, ortho);
+
+    dbg.vertices.reserve(1024 * 6);
+}
+
+bool debug_draw_enabled() {
+    return dbg.enabled;
+}
+
+void debug_draw_set_enabled(bool enabled) {
+    dbg.enabled = enabled;
+    if (!enabled) dbg.vertices.clear();
+}
+
+// Quad arbitrario (4 esquinas en orden) en coordenadas de mundo
+static void push_quad(float x0, float y0, float x1, float y1,
+                      float x2, float y2, float x3, float y3,
+                      float r, float g, float b, float a) {
+    float cx, cy;
+    get_camera(&cx, &cy);
+    x0 -= cx; x1 -= cx; x2 -= cx; x3 -= cx;
+    y0 -= cy; y1 -= cy; y2 -= cy; y3 -= cy;
+
+    dbg.vertices.push_back({x0, y0, r, g, b, a});
+    dbg.vertices.push_back({x1, y1, r, g, b, a});
+    dbg.vertices.push_back({x2, y2, r, g, b, a});
+    dbg.vertices.push_back({x0, y0, r, g, b, a});
+    dbg.vertices.push_back({x2, y2, r, g, b, a});
+    dbg.vertices.push_back({x3, y3, r, g, b, a});
+}
+
+static void push_rect(float x, float y, float w, float h, float r, float g, float b, float a) {
+    push_quad(x, y, x, y + h, x + w, y + h, x + w, y, r, g, b, a);
+}
+
+void debug_draw_rect(float x, float y, float w, float h, float r, float g, float b, float a) {
+    if (!dbg.enabled) return;
+    push_rect(x, y, w, h, r, g, b, a);
+    dbg.primitives++;
+}
+
+// Contorno de 1px hacia dentro (cubre exactamente el AABB)
+void debug_draw_outline(float x, float y, float w, float h, float r, float g, float b, float a) {
+    if (!dbg.enabled) return;
+    if (w <= 2 || h <= 2) {
+        push_rect(x, y, w, h, r, g, b, a);
+    } else {
+        push_rect(x, y, w, 1, r, g, b, a);
+        push_rect(x, y + h - 1, w, 1, r, g, b, a);
+        push_rect(x, y + 1, 1, h - 2, r, g, b, a);
+        push_rect(x + w - 1, y + 1, 1, h - 2, r, g, b, a);
+    }
+    dbg.primitives++;
+}
+
+// Línea de 1px de grosor como quad orientado
+static void push_line(float x0, float y0, float x1, float y1, float r, float g, float b, float a) {
+    float dx = x1 - x0, dy = y1 - y0;
+    float len = std::sqrt(dx * dx + dy * dy);
+    if (len < 0.0001f) {
+        push_rect(x0 - 0.5f, y0 - 0.5f, 1, 1, r, g, b, a);
+        return;
+    }
+    float nx = -dy / len * 0.5f, ny = dx / len * 0.5f;
+    push_quad(x0 + nx, y0 + ny, x0 - nx, y0 - ny, x1 - nx, y1 - ny, x1 + nx, y1 + ny, r, g, b, a);
+}
+
+void debug_draw_line(float x0, float y0, float x1, float y1, float r, float g, float b, float a) {
+    if (!dbg.enabled) return;
+    push_line(x0, y0, x1, y1, r, g, b, a);
+    dbg.primitives++;
+}
+
+void debug_draw_cross(float x, float y, float size, float r, float g, float b, float a) {
+    if (!dbg.enabled) return;
+    float h = size * 0.5f;
+    push_line(x - h, y - h, x + h, y + h, r, g, b, a);
+    push_line(x - h, y + h, x + h, y - h, r, g, b, a);
+    dbg.primitives++;
+}
+
+// Dibuja todo lo encolado en el frame (llamar después de flush_batch)
+void debug_draw_flush() {
+    dbg.stats.primitives = dbg.primitives;
+    dbg.stats.vertices = (Uint32)dbg.vertices.size();
+    dbg.primitives = 0;
+    if (dbg.vertices.empty()) return;
+
+    gl_bind_array_buffer(dbg.VBO);
+    size_t bytes = dbg.vertices.size() * sizeof(DebugVertex);
+    if (dbg.vertices.size() > dbg.vbo_capacity) {
+        // Crecer el VBO al doble para no re-asignar cada frame
+        size_t old_bytes = dbg.vbo_capacity * sizeof(DebugVertex);
+        dbg.vbo_capacity = std::max(dbg.vertices.size(), dbg.vbo_capacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, dbg.vbo_capacity * sizeof(DebugVertex), nullptr, GL_STREAM_DRAW);
+        mem_track(MEM_BATCH, (long long)(dbg.vbo_capacity * sizeof(DebugVertex)) - (long long)old_bytes);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, dbg.vertices.data());
+
+    gl_use_program(dbg.shaderProgram);
+    gl_bind_vertex_array(dbg.VAO);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)dbg.vertices.size());
+    render_stats_draw((Uint32)dbg.vertices.size(), bytes);
+
+    dbg.vertices.clear();
+}
+
+const DebugDrawStats& debug_draw_stats() {
+    return dbg.stats;
+}
+
+#endif
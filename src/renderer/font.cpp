@@ -0,0 +1,333 @@
+/**
+ * src/renderer/font.cpp
+ * Fuentes bitmap: atlas de glifos + métricas (BMFont .fnt en texto o rejilla
+ * monoespaciada). El layout de cada cadena se hace en C++ y se cachea por
+ * (fuente, texto): los HUD y overlays que repiten el mismo texto cada frame
+ * solo copian quads al batch.
+ */
+
+#include "../engine.hpp"
+#include <unordered_map>
+#include <fstream>
+#include <sstream>
+
+struct Glyph {
+    float u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+    float x_off = 0, y_off = 0;
+    float w = 0, h = 0;
+    float advance = 0;
+    bool valid = false;
+};
+
+// Quad de un glifo relativo al origen de la cadena
+struct GlyphQuad {
+    float x, y, w, h;
+    float u0, v0, u1, v1;
+};
+
+struct TextRun {
+    std::vector<GlyphQuad> quads;
+    float width = 0, height = 0;
+    Uint32 last_frame = 0;
+};
+
+struct Font {
+    GLuint texture = 0;
+    float line_height = 0;
+    Glyph ascii[128];                          // Acceso directo para ASCII
+    std::unordered_map<Uint32, Glyph> extended; // Resto de codepoints (UTF-8)
+    std::unordered_map<Uint64, float> kerning;  // (primero << 32 | segundo) -> ajuste
+    std::unordered_map<std::string, TextRun> runs;
+};
+
+struct FontState {
+    std::vector<Font*> fonts;   // id = índice + 1
+    Uint32 frame = 0;
+    TextStats stats;
+};
+
+static FontState fs;
+
+// Frames sin usarse tras los que un run cacheado se descarta
+static const Uint32 RUN_MAX_IDLE_FRAMES = 120;
+
+static Font* get_font(int id) {
+    if (id < 1 || id > (int)fs.fonts.size()) return nullptr;
+    return fs.fonts[id - 1];
+}
+
+static Glyph* find_glyph(Font* font, Uint32 cp) {
+    if (cp < 128) return font->ascii[cp].valid ? &font->ascii[cp] : nullptr;
+    auto it = font->extended.find(cp);
+    return it != font->extended.end() ? &it->second : nullptr;
+}
+
+static void set_glyph(Font* font, Uint32 cp, const Glyph& g) {
+    if (cp < 128) font->ascii[cp] = g;
+    else font->extended[cp] = g;
+}
+
+// Decodifica un codepoint UTF-8 y avanza 'i'. Bytes inválidos se devuelven tal cual.
+static Uint32 next_codepoint(const std::string& s, size_t& i) {
+    unsigned char c = (unsigned char)s[i++];
+    int extra = 0;
+    Uint32 cp = c;
+    if (c >= 0xF0)      { cp = c & 0x07; extra = 3; }
+    else if (c >= 0xE0) { cp = c & 0x0F; extra = 2; }
+    else if (c >= 0xC0) { cp = c & 0x1F; extra = 1; }
+    else return c;
+
+    for (int k = 0; k < extra; ++k) {
+        if (i >= s.size() || ((unsigned char)s[i] & 0xC0) != 0x80) return c;
+        cp = (cp << 6) | ((unsigned char)s[i++] & 0x3F);
+    }
+    return cp;
+}
+
+static int register_font(Font* font) {
+    fs.fonts.push_back(font);
+    return (int)fs.fonts.size();
+}
+
+// Lee "clave=valor" de una línea BMFont (valores entre comillas incluidos)
+static std::map<std::string, std::string> parse_fnt_fields(std::istringstream& line) {
+    std::map<std::string, std::string> fields;
+    std::string token;
+    while (line >> token) {
+        size_t eq = token.find('=');
+        if (eq == std::string::npos) continue;
+        std::string value = token.substr(eq + 1);
+        // Valores con espacios: "mi fuente.png"
+        if (!value.empty() && value[0] == '"') {
+            while (value.size() < 2 || value.back() != '"') {
+                std::string more;
+                if (!(line >> more)) break;
+                value += " " + more;
+            }
+            value = value.substr(1, value.size() >= 2 ? value.size() - 2 : 0);
+        }
+        fields[token.substr(0, eq)] = value;
+    }
+    return fields;
+}
+
+static float field(const std::map<std::string, std::string>& f, const char* key) {
+    auto it = f.find(key);
+    return it != f.end() ? (float)atof(it->second.c_str()) : 0.0f;
+}
+
+// Cargar fuente BMFont (formato texto). La página 0 se busca junto al .fnt.
+int load_font(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "[FONT] No se pudo abrir " << path << std::endl;
+        return 0;
+    }
+
+    std::string dir(path);
+    size_t slash = dir.find_last_of('/');
+    dir = (slash == std::string::npos) ? "" : dir.substr(0, slash + 1);
+
+    Font* font = new Font();
+    float scale_w = 1, scale_h = 1;
+    std::string page_file;
+    std::string raw;
+
+    while (std::getline(file, raw)) {
+        std::istringstream line(raw);
+        std::string tag;
+        line >> tag;
+        auto f = parse_fnt_fields(line);
+
+        if (tag == "common") {
+            font->line_height = field(f, "lineHeight");
+            scale_w = field(f, "scaleW");
+            scale_h = field(f, "scaleH");
+            if (field(f, "pages") > 1) {
+                std::cerr << "[FONT] " << path << ": solo se usa la página 0" << std::endl;
+            }
+        } else if (tag == "page") {
+            if (field(f, "id") == 0) page_file = f["file"];
+        } else if (tag == "char") {
+            if (field(f, "page") != 0) continue;
+            Glyph g;
+            float x = field(f, "x"), y = field(f, "y");
+            g.w = field(f, "width");
+            g.h = field(f, "height");
+            g.x_off = field(f, "xoffset");
+            g.y_off = field(f, "yoffset");
+            g.advance = field(f, "xadvance");
+            g.u0 = x / scale_w;
+            g.v0 = y / scale_h;
+            g.u1 = (x + g.w) / scale_w;
+            g.v1 = (y + g.h) / scale_h;
+            g.valid = true;
+            set_glyph(font, (Uint32)field(f, "id"), g);
+        } else if (tag == "kerning") {
+            Uint64 key = ((Uint64)(Uint32)field(f, "first") << 32) | (Uint32)field(f, "second");
+            font->kerning[key] = field(f, "amount");
+        }
+    }
+
+    if (page_file.empty()) {
+        std::cerr << "[FONT] " << path << ": falta la línea 'page'" << std::endl;
+        delete font;
+        return 0;
+    }
+
+    int tw, th;
+    font->texture = load_texture((dir + page_file).c_str(), &tw, &th);
+    if (!font->texture) {
+        delete font;
+        return 0;
+    }
+    return register_font(font);
+}
+
+// Cargar fuente monoespaciada: el atlas es una rejilla de celdas cell_w x cell_h
+// en orden de codepoint, empezando por 'first' (normalmente 32, el espacio).
+int load_font_grid(const char* path, int cell_w, int cell_h, int first) {
+    int tw, th;
+    GLuint tex = load_texture(path, &tw, &th);
+    if (!tex) return 0;
+
+    if (cell_w <= 0 || cell_h <= 0 || tw < cell_w || th < cell_h) {
+        std::cerr << "[FONT] " << path << ": celdas de " << cell_w << "x" << cell_h
+                  << " no caben en " << tw << "x" << th << std::endl;
+        release_texture(tex);
+        return 0;
+    }
+
+    Font* font = new Font();
+    font->texture = tex;
+    font->line_height = (float)cell_h;
+
+    int cols = tw / cell_w;
+    int count = cols * (th / cell_h);
+    for (int i = 0; i < count; ++i) {
+        Glyph g;
+        float x = (float)((i % cols) * cell_w);
+        float y = (float)((i / cols) * cell_h);
+        g.w = (float)cell_w;
+        g.h = (float)cell_h;
+        g.advance = (float)cell_w;
+        g.u0 = x / tw;
+        g.v0 = y / th;
+        g.u1 = (x + cell_w) / tw;
+        g.v1 = (y + cell_h) / th;
+        g.valid = true;
+        set_glyph(font, (Uint32)(first + i), g);
+    }
+    return register_font(font);
+}
+
+// Layout de una cadena: quads relativos al origen, '\n' baja una línea
+static void layout_text(Font* font, const std::string& text, TextRun& run) {
+    float pen_x = 0, pen_y = 0;
+    Uint32 prev = 0;
+    size_t i = 0;
+
+    run.quads.clear();
+    run.width = 0;
+    run.height = text.empty() ? 0 : font->line_height;
+
+    while (i < text.size()) {
+        Uint32 cp = next_codepoint(text, i);
+        if (cp == '\n') {
+            pen_x = 0;
+            pen_y += font->line_height;
+            run.height += font->line_height;
+            prev = 0;
+            continue;
+        }
+
+        Glyph* g = find_glyph(font, cp);
+        if (!g) g = find_glyph(font, '?');
+        if (!g) continue;
+
+        if (prev && !font->kerning.empty()) {
+            auto k = font->kerning.find(((Uint64)prev << 32) | cp);
+            if (k != font->kerning.end()) pen_x += k->second;
+        }
+
+        // Los espacios no generan quad, solo avanzan
+        if (g->w > 0 && g->h > 0) {
+            run.quads.push_back({pen_x + g->x_off, pen_y + g->y_off, g->w, g->h,
+                                 g->u0, g->v0, g->u1, g->v1});
+        }
+        pen_x += g->advance;
+        if (pen_x > run.width) run.width = pen_x;
+        prev = cp;
+    }
+}
+
+// Devuelve el run cacheado de (fuente, texto), haciendo el layout si falta
+static TextRun& get_run(Font* font, const std::string& text) {
+    auto it = font->runs.find(text);
+    if (it != font->runs.end()) {
+        fs.stats.cache_hits++;
+        it->second.last_frame = fs.frame;
+        return it->second;
+    }
+
+    fs.stats.cache_misses++;
+    TextRun& run = font->runs[text];
+    layout_text(font, text, run);
+    run.last_frame = fs.frame;
+    return run;
+}
+
+void draw_text(int font_id, const std::string& text, float x, float y,
+               float r, float g, float b, float a) {
+    Font* font = get_font(font_id);
+    if (!font) return;
+
+    const TextRun& run = get_run(font, text);
+    for (const GlyphQuad& q : run.quads) {
+        draw_sprite(font->texture, x + q.x, y + q.y, q.w, q.h,
+                    q.u0, q.v0, q.u1, q.v1, r, g, b, a);
+    }
+    fs.stats.glyphs_drawn += run.quads.size();
+}
+
+bool measure_text(int font_id, const std::string& text, float* w, float* h) {
+    Font* font = get_font(font_id);
+    if (!font) return false;
+
+    const TextRun& run = get_run(font, text);
+    if (w) *w = run.width;
+    if (h) *h = run.height;
+    return true;
+}
+
+float font_line_height(int font_id) {
+    Font* font = get_font(font_id);
+    return font ? font->line_height : 0.0f;
+}
+
+// Fin de frame: descarta runs que llevan tiempo sin dibujarse (textos que cambian
+// cada frame, como contadores, no se acumulan). Barrido completo una vez por segundo.
+void text_frame_end() {
+    fs.frame++;
+    if (fs.frame % 60 != 0) return;
+
+    size_t cached = 0;
+    for (Font* font : fs.fonts) {
+        if (!font) continue;
+        for (auto it = font->runs.begin(); it != font->runs.end();) {
+            if (fs.frame - it->second.last_frame > RUN_MAX_IDLE_FRAMES) it = font->runs.erase(it);
+            else ++it;
+        }
+        cached += font->runs.size();
+    }
+    fs.stats.cached_runs = cached;
+}
+
+const TextStats& text_stats() {
+    return fs.stats;
+}
+
+void free_all_fonts() {
+    for (Font* font : fs.fonts) delete font;
+    fs.fonts.clear();
+}
@@ -0,0 +1,132 @@
+/**
+ * src/renderer/gl_state.cpp
+ * Caché de Estado OpenGL: recuerda el programa, VAO, VBO, texturas por unidad
+ * y ubicaciones de uniforms para no repetir llamadas GL redundantes.
+ *
+ * Todo el código del motor debe pasar por estas funciones en lugar de llamar
+ * a glUseProgram/glBindVertexArray/glBindBuffer/glBindTexture directamente;
+ * si alguien toca el estado GL por fuera, debe llamar a gl_state_invalidate().
+ */
+
+#include "../engine.hpp"
+#include <utility>
+
+// Unidades de textura que rastreamos (el motor usa como mucho 2)
+static const GLuint MAX_TEXTURE_UNITS = 8;
+
+struct GLStateCache {
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint array_buffer = 0;
+    GLuint active_unit = 0;
+    GLuint textures[MAX_TEXTURE_UNITS] = {0};
+
+    // false tras invalidar: la siguiente llamada siempre se emite
+    bool program_valid = false;
+    bool vao_valid = false;
+    bool buffer_valid = false;
+    bool unit_valid = false;
+    bool texture_valid[MAX_TEXTURE_UNITS] = {false};
+
+    std::map<std::pair<GLuint, std::string>, GLint> uniforms;
+    GLStateStats stats;
+};
+
+static GLStateCache cache;
+
+void gl_use_program(GLuint program) {
+    if (cache.program_valid && cache.program == program) {
+        cache.stats.skipped++;
+        return;
+    }
+    glUseProgram(program);
+    cache.program = program;
+    cache.program_valid = true;
+    cache.stats.issued++;
+}
+
+void gl_bind_vertex_array(GLuint vao) {
+    if (cache.vao_valid && cache.vao == vao) {
+        cache.stats.skipped++;
+        return;
+    }
+    glBindVertexArray(vao);
+    cache.vao = vao;
+    cache.vao_valid = true;
+    cache.stats.issued++;
+}
+
+void gl_bind_array_buffer(GLuint vbo) {
+    if (cache.buffer_valid && cache.array_buffer == vbo) {
+        cache.stats.skipped++;
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    cache.array_buffer = vbo;
+    cache.buffer_valid = true;
+    cache.stats.issued++;
+}
+
+void gl_active_texture(GLuint unit) {
+    if (cache.unit_valid && cache.active_unit == unit) {
+        cache.stats.skipped++;
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + unit);
+    cache.active_unit = unit;
+    cache.unit_valid = true;
+    cache.stats.issued++;
+}
+
+void gl_bind_texture(GLuint unit, GLuint texture) {
+    if (unit >= MAX_TEXTURE_UNITS) return;
+
+    if (cache.texture_valid[unit] && cache.textures[unit] == texture) {
+        cache.stats.skipped++;
+        return;
+    }
+
+    // Solo cambiamos de unidad activa si hace falta
+    if (!cache.unit_valid || cache.active_unit != unit) gl_active_texture(unit);
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    render_stats_texture_bind();
+    cache.textures[unit] = texture;
+    cache.texture_valid[unit] = true;
+    cache.stats.issued++;
+}
+
+GLint gl_uniform_location(GLuint program, const char* name) {
+    auto key = std::make_pair(program, std::string(name));
+    auto it = cache.uniforms.find(key);
+    if (it != cache.uniforms.end()) {
+        cache.stats.skipped++;
+        return it->second;
+    }
+
+    GLint loc = glGetUniformLocation(program, name);
+    cache.uniforms[key] = loc;
+    cache.stats.issued++;
+    return loc;
+}
+
+// Olvida una textura borrada para que un ID reciclado por GL se vuelva a enlazar
+void gl_state_forget_texture(GLuint texture) {
+    for (GLuint i = 0; i < MAX_TEXTURE_UNITS; ++i) {
+        if (cache.textures[i] == texture) cache.texture_valid[i] = false;
+    }
+}
+
+// Marca todo el estado como desconocido (las ubicaciones de uniforms se conservan:
+// solo cambian si se re-linkea el programa)
+void gl_state_invalidate() {
+    cache.program_valid = false;
+    cache.vao_valid = false;
+    cache.buffer_valid = false;
+    cache.unit_valid = false;
+    for (GLuint i = 0; i < MAX_TEXTURE_UNITS; ++i) cache.texture_valid[i] = false;
+}
+
+const GLStateStats& gl_state_stats() {
+    return cache.stats;
+}
@@ -0,0 +1,125 @@
+/**
+ * src/renderer/palette.cpp
+ * Atlas de paletas para texturas indexadas: una textura RGBA de 256 x PALETTE_ROWS
+ * donde cada fila es una paleta. El batch la enlaza en la unidad 1 y el shader
+ * traduce el índice de la textura R8 con el color de la fila del vértice.
+ *
+ * Las filas se modifican en CPU y se suben (solo las sucias) antes de cada
+ * flush del batch: cambiar de paleta no cuesta texturas ni draw calls extra.
+ */
+
+#include "../engine.hpp"
+#include <cstring>
+
+struct PaletteState {
+    GLuint texture = 0;
+    Uint8 colors[PALETTE_ROWS][PALETTE_SIZE][4] = {};
+    bool used[PALETTE_ROWS] = {false};
+    bool dirty[PALETTE_ROWS] = {false};
+    bool any_dirty = false;
+};
+
+static PaletteState pal;
+
+void init_palettes() {
+    glGenTextures(1, &pal.texture);
+    gl_bind_texture(1, pal.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PALETTE_SIZE, PALETTE_ROWS, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, pal.colors);
+    mem_track(MEM_TEXTURE, (long long)sizeof(pal.colors));
+}
+
+GLuint palette_texture() {
+    return pal.texture;
+}
+
+static bool valid_row(int row) {
+    return row >= 0 && row < PALETTE_ROWS && pal.used[row];
+}
+
+static void mark_dirty(int row) {
+    pal.dirty[row] = true;
+    pal.any_dirty = true;
+}
+
+// Reserva una fila libre, copia de 'from' si es válida (o transparente) -> -1 si no quedan
+int palette_create(int from) {
+    for (int row = 0; row < PALETTE_ROWS; ++row) {
+        if (pal.used[row]) continue;
+
+        pal.used[row] = true;
+        if (valid_row(from)) memcpy(pal.colors[row], pal.colors[from], sizeof(pal.colors[row]));
+        else memset(pal.colors[row], 0, sizeof(pal.colors[row]));
+        mark_dirty(row);
+        return row;
+    }
+    std::cerr << "[PALETTE] Atlas lleno (" << PALETTE_ROWS << " paletas)" << std::endl;
+    return -1;
+}
+
+// Paleta de una imagen indexada de SDL (PNG con PLTE/tRNS)
+int palette_from_sdl(const SDL_Palette* src) {
+    int row = palette_create(-1);
+    if (row < 0 || !src) return row;
+
+    int count = src->ncolors < PALETTE_SIZE ? src->ncolors : PALETTE_SIZE;
+    for (int i = 0; i < count; ++i) {
+        const SDL_Color& c = src->colors[i];
+        Uint8* dst = pal.colors[row][i];
+        dst[0] = c.r; dst[1] = c.g; dst[2] = c.b; dst[3] = c.a;
+    }
+    return row;
+}
+
+void palette_release(int row) {
+    if (!valid_row(row)) return;
+    pal.used[row] = false;
+}
+
+bool palette_set(int row, int index, float r, float g, float b, float a) {
+    if (!valid_row(row) || index < 0 || index >= PALETTE_SIZE) return false;
+
+    auto to_byte = [](float v) -> Uint8 {
+        if (v <= 0.0f) return 0;
+        if (v >= 1.0f) return 255;
+        return (Uint8)(v * 255.0f + 0.5f);
+    };
+    Uint8* dst = pal.colors[row][index];
+    dst[0] = to_byte(r); dst[1] = to_byte(g); dst[2] = to_byte(b); dst[3] = to_byte(a);
+    mark_dirty(row);
+    return true;
+}
+
+bool palette_get(int row, int index, float* rgba) {
+    if (!valid_row(row) || index < 0 || index >= PALETTE_SIZE) return false;
+    for (int i = 0; i < 4; ++i) rgba[i] = pal.colors[row][index][i] / 255.0f;
+    return true;
+}
+
+int palette_count() {
+    int used = 0;
+    for (int row = 0; row < PALETTE_ROWS; ++row) used += pal.used[row] ? 1 : 0;
+    return used;
+}
+
+// Sube las filas modificadas desde el último flush (el batch la llama antes de dibujar)
+void palette_upload() {
+    if (!pal.any_dirty || !pal.texture) return;
+
+    // Con la paleta ya enlazada (acierto de caché) gl_bind_texture no cambia de
+    // unidad: sin esto glTexSubImage2D escribiría en la textura de la unidad 0
+    gl_active_texture(1);
+    gl_bind_texture(1, pal.texture);
+    for (int row = 0; row < PALETTE_ROWS; ++row) {
+        if (!pal.dirty[row]) continue;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, PALETTE_SIZE, 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, pal.colors[row]);
+        render_stats_upload(sizeof(pal.colors[row]));
+        pal.dirty[row] = false;
+    }
+    pal.any_dirty = false;
+}
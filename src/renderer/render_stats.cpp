@@ -0,0 +1,140 @@
+/**
+ * src/renderer/render_stats.cpp
+ * Estadísticas de render por frame (draw calls, vértices, flushes, binds de
+ * textura, bytes subidos) y tiempo de GPU por pasada con queries GL_TIME_ELAPSED.
+ *
+ * Las queries viven en un anillo de RENDER_QUERY_FRAMES frames: el resultado de
+ * un frame se lee cuando su hueco se reutiliza, así que nunca esperamos a la GPU.
+ * Si aún no está disponible, esa medida se descarta (gpu_dropped). Una pasada
+ * descartada o no emitida en ese hueco queda a 0 con gpu_valid = false: nunca
+ * se repite una medida antigua como si fuera actual.
+ */
+
+#include "../engine.hpp"
+#include <cstdio>
+
+static const int RENDER_QUERY_FRAMES = 4;
+
+struct RenderStatsState {
+    RenderFrameStats current;   // Frame en curso
+    RenderFrameStats last;      // Último frame cerrado (contadores)
+
+    GLuint queries[RENDER_QUERY_FRAMES][RENDER_PASS_COUNT] = {};
+    bool issued[RENDER_QUERY_FRAMES][RENDER_PASS_COUNT] = {};
+    int slot = 0;
+    int active_pass = -1;       // Las queries TIME_ELAPSED no se anidan
+    bool gpu_timing = false;
+
+    double gpu_ms[RENDER_PASS_COUNT] = {0};   // Resultado del último hueco leído
+    bool gpu_valid[RENDER_PASS_COUNT] = {};   // ¿gpu_ms es una medida de ese hueco?
+    Uint64 gpu_dropped = 0;
+};
+
+static RenderStatsState rs;
+
+static const char* pass_names[RENDER_PASS_COUNT] = { "scene", "debug" };
+
+const char* render_pass_name(RenderPass pass) {
+    return pass_names[pass];
+}
+
+void init_render_stats() {
+    while (glGetError() != GL_NO_ERROR) {}   // Errores previos no son nuestros
+    glGenQueries(RENDER_QUERY_FRAMES * RENDER_PASS_COUNT, &rs.queries[0][0]);
+    rs.gpu_timing = glGetError() == GL_NO_ERROR;
+    if (!rs.gpu_timing) std::cerr << "[RENDER] Sin queries de tiempo GPU" << std::endl;
+}
+
+// Lee (sin bloquear) los resultados del hueco que vamos a reutilizar
+static void collect_slot(int slot) {
+    for (int p = 0; p < RENDER_PASS_COUNT; ++p) {
+        rs.gpu_ms[p] = 0.0;
+        rs.gpu_valid[p] = false;
+        if (!rs.issued[slot][p]) continue;
+        rs.issued[slot][p] = false;
+
+        GLint available = 0;
+        glGetQueryObjectiv(rs.queries[slot][p], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            rs.gpu_dropped++;
+            continue;
+        }
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(rs.queries[slot][p], GL_QUERY_RESULT, &ns);
+        rs.gpu_ms[p] = ns / 1e6;
+        rs.gpu_valid[p] = true;
+    }
+}
+
+void render_stats_begin_frame() {
+    rs.current = RenderFrameStats();
+    if (!rs.gpu_timing) return;
+
+    rs.slot = (rs.slot + 1) % RENDER_QUERY_FRAMES;
+    collect_slot(rs.slot);
+}
+
+void render_stats_end_frame() {
+    if (rs.active_pass >= 0) render_pass_end();
+    rs.last = rs.current;
+    for (int p = 0; p < RENDER_PASS_COUNT; ++p) {
+        rs.last.gpu_ms[p] = rs.gpu_ms[p];
+        rs.last.gpu_valid[p] = rs.gpu_valid[p];
+    }
+    rs.last.gpu_dropped = rs.gpu_dropped;
+}
+
+void render_pass_begin(RenderPass pass) {
+    if (!rs.gpu_timing) return;
+    if (rs.active_pass >= 0) render_pass_end();
+    glBeginQuery(GL_TIME_ELAPSED, rs.queries[rs.slot][pass]);
+    rs.active_pass = pass;
+}
+
+void render_pass_end() {
+    if (!rs.gpu_timing || rs.active_pass < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    rs.issued[rs.slot][rs.active_pass] = true;
+    rs.active_pass = -1;
+}
+
+void render_stats_draw(Uint32 vertices, size_t bytes_uploaded) {
+    rs.current.draw_calls++;
+    rs.current.vertices += vertices;
+    rs.current.bytes_uploaded += bytes_uploaded;
+}
+
+// Subidas que no son geometría (filas de paleta)
+void render_stats_upload(size_t bytes) {
+    rs.current.bytes_uploaded += bytes;
+}
+
+void render_stats_flush(FlushReason reason) {
+    rs.current.flushes++;
+    rs.current.flush_reasons[reason]++;
+}
+
+void render_stats_texture_bind() {
+    rs.current.texture_binds++;
+}
+
+const RenderFrameStats& render_stats() {
+    return rs.last;
+}
+
+// Línea compacta para la salida del profiler ("-" si la pasada no tiene medida)
+std::string render_report_line() {
+    const RenderFrameStats& s = rs.last;
+    char gpu[RENDER_PASS_COUNT][16];
+    for (int p = 0; p < RENDER_PASS_COUNT; ++p) {
+        if (s.gpu_valid[p]) snprintf(gpu[p], sizeof(gpu[p]), "%.2fms", s.gpu_ms[p]);
+        else snprintf(gpu[p], sizeof(gpu[p]), "-");
+    }
+    char line[256];
+    snprintf(line, sizeof(line),
+             "render draws=%u verts=%u flushes=%u binds=%u upload=%.1fKB gpu %s=%s %s=%s",
+             s.draw_calls, s.vertices, s.flushes, s.texture_binds, s.bytes_uploaded / 1024.0,
+             pass_names[RENDER_PASS_SCENE], gpu[RENDER_PASS_SCENE],
+             pass_names[RENDER_PASS_DEBUG], gpu[RENDER_PASS_DEBUG]);
+    return line;
+}
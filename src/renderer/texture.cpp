@@ -1,7 +1,68 @@
 #include "../engine.hpp"
+#include <unordered_map>
+
+// Caché de texturas: una carga por ruta, con referencias y último uso (LRU)
+struct CachedTexture {
+    std::string path;
+    int w = 0, h = 0;
+    size_t bytes = 0;      // VRAM estimada
+    int refs = 0;
+    Uint32 last_used = 0;
+    int palette = -1;      // Paleta propia de una textura indexada (-1 = RGBA)
+};
+
+static std::unordered_map<GLuint, CachedTexture> textures;
+static std::map<std::string, GLuint> texture_by_path;
+
+static void delete_texture(GLuint id) {
+    auto it = textures.find(id);
+    if (it == textures.end()) return;
+
+    mem_track(MEM_TEXTURE, -(long long)it->second.bytes);
+    palette_release(it->second.palette);
+    texture_by_path.erase(it->second.path);
+    textures.erase(it);
+
+    batch_forget_texture(id);
+    gl_state_forget_texture(id);
+    glDeleteTextures(1, &id);
+}
+
+// Desalojador LRU: borra texturas sin referencias, la menos usada primero.
+// mem_frame_update() lo llama al inicio del frame, con el batch ya vacío.
+static size_t evict_textures(size_t bytes) {
+    size_t freed = 0;
+
+    while (freed < bytes) {
+        GLuint victim = 0;
+        Uint32 oldest = 0xFFFFFFFF;
+        for (const auto& [id, tex] : textures) {
+            if (tex.refs <= 0 && tex.last_used <= oldest) {
+                oldest = tex.last_used;
+                victim = id;
+            }
+        }
+        if (!victim) break;
+
+        freed += textures[victim].bytes;
+        delete_texture(victim);
+    }
+    return freed;
+}
 
 // Cargar textura desde archivo (usando SDL_image)
 GLuint load_texture(const char* path, int* w, int* h) {
+    // Ya cargada: sumar referencia
+    auto cached = texture_by_path.find(path);
+    if (cached != texture_by_path.end()) {
+        CachedTexture& tex = textures[cached->second];
+        tex.refs++;
+        tex.last_used = SDL_GetTicks();
+        if (w) *w = tex.w;
+        if (h) *h = tex.h;
+        return cached->second;
+    }
+
     SDL_Surface* surface = IMG_Load(path);
     if (!surface) {
         std::cerr << "[TEXTURE] Error cargando " << path << ": " << IMG_GetError() << std::endl;
@@ -10,7 +71,8 @@ GLuint load_texture(const char* path, int* w, int* h) {
 
     GLuint textureID;
     glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    // Enlazamos a través de la caché para que el batch sepa qué quedó en la unidad 0
+    gl_bind_texture(0, textureID);
 
     // Configuración Pixel-Art (Nearest Neighbor)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -27,6 +89,124 @@ GLuint load_texture(const char* path, int* w, int* h) {
     if (w) *w = surface->w;
     if (h) *h = surface->h;
 
+    // Los drivers guardan RGB como RGBA: estimamos 4 bytes por píxel
+    CachedTexture tex;
+    tex.path = path;
+    tex.w = surface->w;
+    tex.h = surface->h;
+    tex.bytes = (size_t)surface->w * (size_t)surface->h * 4;
+    tex.refs = 1;
+    tex.last_used = SDL_GetTicks();
+    textures[textureID] = tex;
+    texture_by_path[path] = textureID;
+    mem_track(MEM_TEXTURE, (long long)tex.bytes);
+    mem_set_evictor(MEM_TEXTURE, evict_textures);
+
     SDL_FreeSurface(surface);
     return textureID;
 }
+
+// Cargar una imagen de 8 bits con paleta (PNG indexado) como textura R8: cada
+// texel guarda el índice y el color sale del atlas de paletas en el shader.
+// La paleta del archivo se copia a una fila propia (palette_out).
+GLuint load_texture_indexed(const char* path, int* w, int* h, int* palette_out) {
+    // Clave distinta de load_texture: la misma imagen puede existir en ambos formatos
+    std::string key = std::string("indexed:") + path;
+    auto cached = texture_by_path.find(key);
+    if (cached != texture_by_path.end()) {
+        CachedTexture& tex = textures[cached->second];
+        tex.refs++;
+        tex.last_used = SDL_GetTicks();
+        if (w) *w = tex.w;
+        if (h) *h = tex.h;
+        if (palette_out) *palette_out = tex.palette;
+        return cached->second;
+    }
+
+    SDL_Surface* surface = IMG_Load(path);
+    if (!surface) {
+        std::cerr << "[TEXTURE] Error cargando " << path << ": " << IMG_GetError() << std::endl;
+        return 0;
+    }
+    if (surface->format->BitsPerPixel != 8 || !surface->format->palette) {
+        std::cerr << "[TEXTURE] " << path << " no es una imagen indexada de 8 bits" << std::endl;
+        SDL_FreeSurface(surface);
+        return 0;
+    }
+
+    int palette = palette_from_sdl(surface->format->palette);
+    if (palette < 0) {
+        SDL_FreeSurface(surface);
+        return 0;
+    }
+
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    gl_bind_texture(0, textureID);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Filas de 1 byte por píxel: el pitch de SDL no tiene por qué ser múltiplo de 4
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, surface->pitch);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, surface->w, surface->h, 0, GL_RED, GL_UNSIGNED_BYTE, surface->pixels);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (w) *w = surface->w;
+    if (h) *h = surface->h;
+    if (palette_out) *palette_out = palette;
+
+    CachedTexture tex;
+    tex.path = key;
+    tex.w = surface->w;
+    tex.h = surface->h;
+    tex.bytes = (size_t)surface->w * (size_t)surface->h;
+    tex.refs = 1;
+    tex.last_used = SDL_GetTicks();
+    tex.palette = palette;
+    textures[textureID] = tex;
+    texture_by_path[key] = textureID;
+    mem_track(MEM_TEXTURE, (long long)tex.bytes);
+    mem_set_evictor(MEM_TEXTURE, evict_textures);
+
+    SDL_FreeSurface(surface);
+    return textureID;
+}
+
+// Textura blanca 1x1 para rectángulos de color (batch.draw multiplica por el color
+// del vértice). Se crea bajo demanda y nunca se desaloja.
+GLuint white_texture() {
+    static GLuint white = 0;
+    if (white) return white;
+
+    const unsigned char pixel[4] = {255, 255, 255, 255};
+    glGenTextures(1, &white);
+    gl_bind_texture(0, white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    return white;
+}
+
+// Quita una referencia; la textura sigue en caché hasta que haga falta su VRAM
+void release_texture(GLuint texture) {
+    auto it = textures.find(texture);
+    if (it != textures.end() && it->second.refs > 0) it->second.refs--;
+}
+
+// Marca la textura como usada ahora (el batch la llama al cambiar de textura).
+// Devuelve su paleta propia (-1 si es RGBA) para los sprites dibujados sin paleta.
+int touch_texture(GLuint texture) {
+    auto it = textures.find(texture);
+    if (it == textures.end()) return -1;
+    it->second.last_used = SDL_GetTicks();
+    return it->second.palette;
+}
+
+void free_all_textures() {
+    while (!textures.empty()) delete_texture(textures.begin()->first);
+}
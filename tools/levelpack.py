@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+tools/levelpack.py
+Convierte un nivel JSON editable a formato binario .xlv por chunks
+(ver src/level/stream.cpp para el formato).
+
+Uso: python3 tools/levelpack.py levels/parkour.json levels/parkour.xlv
+
+JSON de entrada:
+{
+    "tile_size": 16,              # px
+    "width": 102, "height": 25,   # en tiles
+    "chunk_tiles": 16,            # lado del chunk en tiles (opcional)
+    "tileset": "assets/tiles/parkour.png",
+    "layers": [[...]],            # capas de tiles: width*height ids (0 = vacío)
+    "collision": [...],           # opcional: width*height, != 0 = sólido
+    "solids": [{"x": 0, "y": 200, "w": 300, "h": 50}],   # rects en px
+    "entities": [{"type": "metool", "x": 560, "y": 100}]
+}
+
+Los sólidos se recortan a cada chunk que tocan (los chunks del borde se quedan
+también lo que sobresale del nivel, como paredes tope en x < 0); la capa de
+colisión se funde en rects horizontales por fila. Cada entidad va al chunk de
+su punto de spawn con un id estable (su índice en el JSON).
+"""
+
+import json
+import struct
+import sys
+
+HEADER = struct.Struct("<4sHHIIHHIIHH")   # 32 bytes
+DIR_ENTRY = struct.Struct("<II")
+OUTSIDE = 1 << 30
+
+
+def rle(tiles):
+    """Pares (cuenta, tile) en u16."""
+    out = bytearray()
+    i = 0
+    while i < len(tiles):
+        tile = tiles[i]
+        run = 1
+        while i + run < len(tiles) and tiles[i + run] == tile and run < 0xFFFF:
+            run += 1
+        out += struct.pack("<HH", run, tile)
+        i += run
+    return bytes(out)
+
+
+def collision_rects(grid, width, height, ts):
+    """Funde celdas sólidas contiguas de cada fila en un rect."""
+    rects = []
+    for ty in range(height):
+        tx = 0
+        while tx < width:
+            if grid[ty * width + tx]:
+                start = tx
+                while tx < width and grid[ty * width + tx]:
+                    tx += 1
+                rects.append({"x": start * ts, "y": ty * ts, "w": (tx - start) * ts, "h": ts})
+            else:
+                tx += 1
+    return rects
+
+
+def clip(rect, x0, y0, x1, y1):
+    """Intersección de rect con la caja [x0, x1) x [y0, y1) o None."""
+    ax0, ay0 = max(rect["x"], x0), max(rect["y"], y0)
+    ax1, ay1 = min(rect["x"] + rect["w"], x1), min(rect["y"] + rect["h"], y1)
+    if ax1 <= ax0 or ay1 <= ay0:
+        return None
+    return ax0, ay0, ax1 - ax0, ay1 - ay0
+
+
+def pack(level):
+    ts = int(level.get("tile_size", 16))
+    width = int(level["width"])
+    height = int(level["height"])
+    ct = int(level.get("chunk_tiles", 16))
+    layers = level.get("layers", [])
+    tileset = level.get("tileset", "").encode("utf-8")
+
+    for i, layer in enumerate(layers):
+        if len(layer) != width * height:
+            raise ValueError(f"capa {i}: {len(layer)} tiles, se esperaban {width * height}")
+
+    solids = list(level.get("solids", []))
+    if "collision" in level:
+        solids += collision_rects(level["collision"], width, height, ts)
+
+    chunks_x = (width + ct - 1) // ct
+    chunks_y = (height + ct - 1) // ct
+    chunk_px = ct * ts
+
+    # Entidades por chunk (id estable = índice en el JSON)
+    spawns = {}
+    for index, ent in enumerate(level.get("entities", [])):
+        x, y = int(ent["x"]), int(ent["y"])
+        cx = min(max(x // chunk_px, 0), chunks_x - 1)
+        cy = min(max(y // chunk_px, 0), chunks_y - 1)
+        spawns.setdefault(cy * chunks_x + cx, []).append((index + 1, x, y, ent["type"]))
+
+    payloads = []
+    for cy in range(chunks_y):
+        for cx in range(chunks_x):
+            data = bytearray()
+            empty = True
+
+            for layer in layers:
+                tiles = []
+                for ly in range(ct):
+                    for lx in range(ct):
+                        tx, ty = cx * ct + lx, cy * ct + ly
+                        tile = layer[ty * width + tx] if tx < width and ty < height else 0
+                        tiles.append(tile)
+                        empty = empty and tile == 0
+                data += rle(tiles)
+
+            x0, y0 = cx * chunk_px, cy * chunk_px
+            x1, y1 = x0 + chunk_px, y0 + chunk_px
+            # Bordes del nivel: el chunk se extiende hacia fuera
+            if cx == 0:
+                x0 = -OUTSIDE
+            if cy == 0:
+                y0 = -OUTSIDE
+            if cx == chunks_x - 1:
+                x1 = OUTSIDE
+            if cy == chunks_y - 1:
+                y1 = OUTSIDE
+            clipped = [c for c in (clip(s, x0, y0, x1, y1) for s in solids) if c]
+            data += struct.pack("<H", len(clipped))
+            for x, y, w, h in clipped:
+                data += struct.pack("<iiHH", x, y, w, h)
+
+            chunk_spawns = spawns.get(cy * chunks_x + cx, [])
+            data += struct.pack("<H", len(chunk_spawns))
+            for sid, x, y, kind in chunk_spawns:
+                name = kind.encode("utf-8")
+                data += struct.pack("<IiiB", sid, x, y, len(name)) + name
+
+            if empty and not clipped and not chunk_spawns:
+                data = b""   # Directorio con tamaño 0: nada que leer
+            payloads.append(bytes(data))
+
+    out = bytearray(HEADER.pack(b"XLV1", 1, ts, width, height, ct, len(layers),
+                                chunks_x, chunks_y, len(tileset), 0))
+    out += tileset
+    offset = len(out) + DIR_ENTRY.size * len(payloads)
+    for data in payloads:
+        out += DIR_ENTRY.pack(offset if data else 0, len(data))
+        offset += len(data)
+    for data in payloads:
+        out += data
+    return bytes(out), chunks_x, chunks_y
+
+
+def main(argv):
+    if len(argv) != 3:
+        print("Uso: python3 tools/levelpack.py nivel.json nivel.xlv", file=sys.stderr)
+        return 1
+
+    with open(argv[1], encoding="utf-8") as f:
+        level = json.load(f)
+    data, chunks_x, chunks_y = pack(level)
+    with open(argv[2], "wb") as f:
+        f.write(data)
+    print(f"[LEVELPACK] {argv[2]}: {chunks_x}x{chunks_y} chunks, {len(data)} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))